@@ -0,0 +1,77 @@
+#include "benchmark/benchmark.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCParser/AsmLexer.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include <memory>
+#include <string>
+
+using namespace llvm;
+
+static const char *TripleName = "x86_64-unknown-linux-gnu";
+
+// Compiler-style assembly: directives, labels, comments, identifiers with
+// dots and dollars, registers, memory operands and integer literals.
+static std::string createAsm(unsigned NumFunctions) {
+  std::string Asm;
+  raw_string_ostream OS(Asm);
+  for (unsigned I = 0; I != NumFunctions; ++I) {
+    OS << "\t.globl\t_Z4funcILi" << I << "EEvv\n"
+       << "\t.p2align\t4, 0x90\n"
+       << "\t.type\t_Z4funcILi" << I << "EEvv,@function\n"
+       << "_Z4funcILi" << I << "EEvv:                   # @func\n"
+       << "\t.cfi_startproc\n"
+       << "# %bb.0:                                # %entry\n"
+       << "\tpushq\t%rbp\n"
+       << "\tmovq\t%rsp, %rbp\n"
+       << "\tmovl\t$" << I * 31 << ", -4(%rbp)\n"
+       << "\tleaq\t.L.str." << I << "(%rip), %rdi\n"
+       << "\tcallq\tputs@PLT\n"
+       << ".LBB" << I << "_1:                                # %loop\n"
+       << "\taddl\t$1, -4(%rbp)\n"
+       << "\tcmpl\t$0x100, -4(%rbp)\n"
+       << "\tjne\t.LBB" << I << "_1\n"
+       << "\tpopq\t%rbp\n"
+       << "\tretq\n"
+       << ".Lfunc_end" << I << ":\n"
+       << "\t.size\t_Z4funcILi" << I << "EEvv, .Lfunc_end" << I
+       << "-_Z4funcILi" << I << "EEvv\n"
+       << "\t.cfi_endproc\n";
+  }
+  return OS.str();
+}
+
+static void BM_LexAsm(benchmark::State &State) {
+  std::string Error;
+  const Target *T = TargetRegistry::lookupTarget(TripleName, Error);
+  if (!T) {
+    State.SkipWithError(Error.c_str());
+    return;
+  }
+  std::unique_ptr<MCRegisterInfo> MRI(T->createMCRegInfo(TripleName));
+  std::unique_ptr<MCAsmInfo> MAI(T->createMCAsmInfo(*MRI, TripleName));
+  std::string Asm = createAsm(State.range(0));
+
+  size_t NumTokens = 0;
+  for (auto _ : State) {
+    AsmLexer Lexer(*MAI);
+    Lexer.setBuffer(Asm);
+    while (Lexer.Lex().isNot(AsmToken::Eof))
+      ++NumTokens;
+  }
+  State.SetBytesProcessed(State.iterations() * Asm.size());
+  State.SetItemsProcessed(NumTokens);
+}
+BENCHMARK(BM_LexAsm)->RangeMultiplier(8)->Range(64, 32768);
+
+int main(int argc, char **argv) {
+  InitializeAllTargetInfos();
+  InitializeAllTargetMCs();
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+  benchmark::RunSpecifiedBenchmarks();
+}
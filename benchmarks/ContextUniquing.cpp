@@ -0,0 +1,84 @@
+#include "benchmark/benchmark.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/Attributes.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Metadata.h"
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+// All threads share one context. Each thread starts at a different offset in
+// the same range of keys, so both lookups of existing entries and insertions
+// of new ones are measured.
+static LLVMContext &getContext() {
+  static LLVMContext Context;
+  return Context;
+}
+
+static const unsigned NumKeys = 1 << 16;
+
+static unsigned getStartKey(const benchmark::State &State) {
+  return State.thread_index * (NumKeys / 16);
+}
+
+static void BM_ConstantIntGet(benchmark::State &State) {
+  IntegerType *Ty = Type::getInt64Ty(getContext());
+  unsigned Key = getStartKey(State);
+  for (auto _ : State)
+    benchmark::DoNotOptimize(ConstantInt::get(Ty, Key++ % NumKeys));
+}
+
+static void BM_ConstantFPGet(benchmark::State &State) {
+  Type *Ty = Type::getDoubleTy(getContext());
+  unsigned Key = getStartKey(State);
+  for (auto _ : State)
+    benchmark::DoNotOptimize(ConstantFP::get(Ty, Key++ % NumKeys));
+}
+
+static void BM_MDStringGet(benchmark::State &State) {
+  std::vector<std::string> Strings;
+  for (unsigned I = 0; I != NumKeys; ++I)
+    Strings.push_back("md" + std::to_string(I));
+  unsigned Key = getStartKey(State);
+  for (auto _ : State)
+    benchmark::DoNotOptimize(
+        MDString::get(getContext(), Strings[Key++ % NumKeys]));
+}
+
+static void BM_TypeGet(benchmark::State &State) {
+  LLVMContext &Context = getContext();
+  unsigned Key = getStartKey(State);
+  for (auto _ : State) {
+    Type *IntTy = IntegerType::get(Context, 1 + Key % 256);
+    benchmark::DoNotOptimize(ArrayType::get(IntTy, Key++ % NumKeys));
+  }
+}
+
+static void BM_AttributeGet(benchmark::State &State) {
+  std::vector<std::string> Values;
+  for (unsigned I = 0; I != NumKeys; ++I)
+    Values.push_back(std::to_string(I));
+  unsigned Key = getStartKey(State);
+  for (auto _ : State)
+    benchmark::DoNotOptimize(
+        Attribute::get(getContext(), "attr", Values[Key++ % NumKeys]));
+}
+
+// Without LLVM_ENABLE_THREADSAFE_LEAF_UNIQUING a context may only be used from
+// one thread at a time, so only the single-threaded numbers can be measured.
+#if LLVM_ENABLE_THREADSAFE_LEAF_UNIQUING
+#define CONTEXT_THREADS ThreadRange(1, 16)
+#else
+#define CONTEXT_THREADS Threads(1)
+#endif
+
+BENCHMARK(BM_ConstantIntGet)->CONTEXT_THREADS;
+BENCHMARK(BM_ConstantFPGet)->CONTEXT_THREADS;
+BENCHMARK(BM_MDStringGet)->CONTEXT_THREADS;
+BENCHMARK(BM_TypeGet)->CONTEXT_THREADS;
+BENCHMARK(BM_AttributeGet)->CONTEXT_THREADS;
+
+BENCHMARK_MAIN();
@@ -0,0 +1,152 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/MC/MCAsmBackend.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCCodeEmitter.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/MC/MCObjectWriter.h"
+#include "llvm/MC/MCParser/MCAsmParser.h"
+#include "llvm/MC/MCParser/MCTargetAsmParser.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCStreamer.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/MCTargetOptions.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include <memory>
+#include <string>
+
+using namespace llvm;
+using namespace llvm::object;
+
+static const char *TripleName = "x86_64-unknown-linux-gnu";
+
+// Assemble Asm into an ELF object in Out, the way llvm-mc -filetype=obj does.
+static bool assemble(const Target &T, const std::string &Asm,
+                     SmallVectorImpl<char> &Out) {
+  Triple TheTriple(TripleName);
+  SourceMgr SrcMgr;
+  SrcMgr.AddNewSourceBuffer(MemoryBuffer::getMemBuffer(Asm), SMLoc());
+
+  std::unique_ptr<MCRegisterInfo> MRI(T.createMCRegInfo(TripleName));
+  std::unique_ptr<MCAsmInfo> MAI(T.createMCAsmInfo(*MRI, TripleName));
+  std::unique_ptr<MCInstrInfo> MCII(T.createMCInstrInfo());
+  std::unique_ptr<MCSubtargetInfo> STI(
+      T.createMCSubtargetInfo(TripleName, "", ""));
+  MCTargetOptions MCOptions;
+
+  MCObjectFileInfo MOFI;
+  MCContext Ctx(MAI.get(), MRI.get(), &MOFI, &SrcMgr);
+  MOFI.InitMCObjectFileInfo(TheTriple, /*PIC=*/false, Ctx);
+  Ctx.setUseNamesOnTempLabels(false);
+
+  raw_svector_ostream OS(Out);
+  MCAsmBackend *MAB = T.createMCAsmBackend(*STI, *MRI, MCOptions);
+  std::unique_ptr<MCStreamer> Str(T.createMCObjectStreamer(
+      TheTriple, Ctx, std::unique_ptr<MCAsmBackend>(MAB),
+      MAB->createObjectWriter(OS),
+      std::unique_ptr<MCCodeEmitter>(T.createMCCodeEmitter(*MCII, *MRI, Ctx)),
+      *STI, /*RelaxAll=*/false, /*IncrementalLinkerCompatible=*/false,
+      /*DWARFMustBeAtTheEnd=*/false));
+
+  std::unique_ptr<MCAsmParser> Parser(
+      createMCAsmParser(SrcMgr, Ctx, *Str, *MAI));
+  std::unique_ptr<MCTargetAsmParser> TAP(
+      T.createMCAsmParser(*STI, *Parser, *MCII, MCOptions));
+  if (!TAP)
+    return false;
+  Parser->setTargetParser(*TAP);
+  return !Parser->Run(/*NoInitialTextSection=*/false);
+}
+
+// An object with a section, a global symbol and a relocation per function,
+// like one built with -ffunction-sections.
+static std::string createAsm(unsigned NumFunctions) {
+  std::string Asm;
+  raw_string_ostream OS(Asm);
+  for (unsigned I = 0; I != NumFunctions; ++I) {
+    OS << "\t.section\t.text._Z4funcILi" << I << "EEvv,\"ax\",@progbits\n"
+       << "\t.globl\t_Z4funcILi" << I << "EEvv\n"
+       << "_Z4funcILi" << I << "EEvv:\n"
+       << "\tcallq\t_Z4funcILi" << (I + 1) % NumFunctions << "EEvv\n"
+       << "\tretq\n";
+  }
+  return OS.str();
+}
+
+// Walk the names of all sections and symbols, and the symbols of all
+// relocations, the way llvm-objdump -r -t -h does.
+static void BM_QueryNames(benchmark::State &State) {
+  std::string Error;
+  const Target *T = TargetRegistry::lookupTarget(TripleName, Error);
+  if (!T) {
+    State.SkipWithError(Error.c_str());
+    return;
+  }
+  SmallString<0> Obj;
+  if (!assemble(*T, createAsm(State.range(0)), Obj)) {
+    State.SkipWithError("failed to assemble");
+    return;
+  }
+  Expected<std::unique_ptr<ObjectFile>> ObjOrErr =
+      ObjectFile::createObjectFile(MemoryBufferRef(Obj, "bench.o"));
+  if (!ObjOrErr) {
+    consumeError(ObjOrErr.takeError());
+    State.SkipWithError("failed to read the object");
+    return;
+  }
+  const ObjectFile &O = **ObjOrErr;
+
+  size_t NumQueries = 0;
+  for (auto _ : State) {
+    for (const SectionRef &Sec : O.sections()) {
+      StringRef Name;
+      if (Sec.getName(Name)) {
+        State.SkipWithError("bad section name");
+        return;
+      }
+      benchmark::DoNotOptimize(Name.data());
+      for (const RelocationRef &Rel : Sec.relocations()) {
+        Expected<StringRef> SymName = Rel.getSymbol()->getName();
+        if (!SymName) {
+          consumeError(SymName.takeError());
+          State.SkipWithError("bad relocation symbol name");
+          return;
+        }
+        benchmark::DoNotOptimize(SymName->data());
+        ++NumQueries;
+      }
+      ++NumQueries;
+    }
+    for (const SymbolRef &Sym : O.symbols()) {
+      Expected<StringRef> Name = Sym.getName();
+      if (!Name) {
+        consumeError(Name.takeError());
+        State.SkipWithError("bad symbol name");
+        return;
+      }
+      benchmark::DoNotOptimize(Name->data());
+      ++NumQueries;
+    }
+  }
+  State.SetItemsProcessed(NumQueries);
+}
+BENCHMARK(BM_QueryNames)->RangeMultiplier(8)->Range(64, 32768);
+
+int main(int argc, char **argv) {
+  InitializeAllTargetInfos();
+  InitializeAllTargetMCs();
+  InitializeAllAsmParsers();
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+  benchmark::RunSpecifiedBenchmarks();
+}
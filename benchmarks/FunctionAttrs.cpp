@@ -0,0 +1,78 @@
+#include "benchmark/benchmark.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/InitializePasses.h"
+#include "llvm/PassRegistry.h"
+#include "llvm/Transforms/IPO/FunctionAttrs.h"
+#include <memory>
+#include <random>
+
+using namespace llvm;
+
+// A module with NumFuncs functions taking a pointer argument. Each one loads
+// or stores a global or a local, and calls a few others, mostly further down
+// the list so that the call graph is deep, with some back edges that form
+// larger SCCs. The pointer is passed along to some of the callees.
+static std::unique_ptr<Module> createCallGraphModule(LLVMContext &Context,
+                                                     unsigned NumFuncs) {
+  auto M = llvm::make_unique<Module>("functionattrs", Context);
+  IntegerType *I32 = Type::getInt32Ty(Context);
+  PointerType *I32Ptr = I32->getPointerTo();
+  auto *G = new GlobalVariable(*M, I32, false, GlobalValue::ExternalLinkage,
+                               ConstantInt::get(I32, 0), "g");
+  FunctionType *FTy = FunctionType::get(I32, {I32Ptr}, false);
+
+  std::vector<Function *> Funcs;
+  for (unsigned I = 0; I != NumFuncs; ++I)
+    Funcs.push_back(Function::Create(FTy, GlobalValue::ExternalLinkage,
+                                     "f" + Twine(I), M.get()));
+
+  std::mt19937 Rand(0);
+  for (unsigned I = 0; I != NumFuncs; ++I) {
+    Function *F = Funcs[I];
+    IRBuilder<> B(BasicBlock::Create(Context, "entry", F));
+    Value *Local = B.CreateAlloca(I32);
+    Value *Arg = &*F->arg_begin();
+    B.CreateStore(B.getInt32(I), Local);
+    if (Rand() % 4 == 0)
+      B.CreateStore(B.getInt32(I), G);
+    else
+      B.CreateLoad(G);
+    for (unsigned J = 0, E = Rand() % 4; J != E; ++J) {
+      unsigned Callee = Rand() % 8 == 0 ? Rand() % NumFuncs
+                                        : I + Rand() % (NumFuncs - I);
+      B.CreateCall(Funcs[Callee], {Rand() % 2 ? Arg : Local});
+    }
+    B.CreateRet(B.CreateLoad(Local));
+  }
+  return M;
+}
+
+template <Pass *(*CreatePass)()>
+static void BM_FunctionAttrs(benchmark::State &State) {
+  // The passes require analyses that are registered the way opt does.
+  initializeAnalysis(*PassRegistry::getPassRegistry());
+  LLVMContext Context;
+  for (auto _ : State) {
+    State.PauseTiming();
+    std::unique_ptr<Module> M = createCallGraphModule(Context, State.range(0));
+    legacy::PassManager PM;
+    PM.add(CreatePass());
+    State.ResumeTiming();
+    PM.run(*M);
+  }
+}
+
+// The post-order CGSCC pass, which scans each body when visiting its SCC.
+BENCHMARK_TEMPLATE(BM_FunctionAttrs, createPostOrderFunctionAttrsLegacyPass)
+    ->RangeMultiplier(8)
+    ->Range(64, 32768);
+
+// Summaries computed in parallel, then propagated over the call graph.
+BENCHMARK_TEMPLATE(BM_FunctionAttrs, createSummaryFunctionAttrsLegacyPass)
+    ->RangeMultiplier(8)
+    ->Range(64, 32768);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,112 @@
+#include "benchmark/benchmark.h"
+#include "llvm/Analysis/BasicAliasAnalysis.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/InitializePasses.h"
+#include "llvm/PassRegistry.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Transforms/Scalar/GVN.h"
+#include <memory>
+
+using namespace llvm;
+
+static const unsigned NumGlobals = 64;
+
+// A function made of a chain of NumDiamonds diamonds. Both arms of each
+// diamond and its join block load one of NumGlobals globals and add it to a
+// running sum, so most loads are redundant with a load several blocks up.
+// If StorePeriod is not zero, the left arm of every StorePeriod-th diamond
+// also stores the sum to another global.
+static std::unique_ptr<Module> createDiamondsModule(LLVMContext &Context,
+                                                    unsigned NumDiamonds,
+                                                    unsigned StorePeriod) {
+  auto M = llvm::make_unique<Module>("gvn", Context);
+  IntegerType *I32 = Type::getInt32Ty(Context);
+  SmallVector<GlobalVariable *, 64> Globals;
+  for (unsigned I = 0; I != NumGlobals; ++I)
+    Globals.push_back(new GlobalVariable(*M, I32, false,
+                                         GlobalValue::ExternalLinkage,
+                                         ConstantInt::get(I32, 0)));
+  Function *F = Function::Create(FunctionType::get(I32, false),
+                                 GlobalValue::ExternalLinkage, "f", M.get());
+  IRBuilder<> B(BasicBlock::Create(Context, "entry", F));
+  Value *Sum = B.getInt32(0);
+  unsigned Next = 0;
+  auto NextGlobal = [&] {
+    Next = (Next * 37 + 11) % NumGlobals;
+    return Globals[Next];
+  };
+  for (unsigned I = 0; I != NumDiamonds; ++I) {
+    BasicBlock *Left = BasicBlock::Create(Context, "left", F);
+    BasicBlock *Right = BasicBlock::Create(Context, "right", F);
+    BasicBlock *Join = BasicBlock::Create(Context, "join", F);
+    B.CreateCondBr(B.CreateICmpSLT(Sum, B.getInt32(I)), Left, Right);
+
+    B.SetInsertPoint(Left);
+    Value *LeftSum = B.CreateAdd(Sum, B.CreateLoad(NextGlobal()));
+    if (StorePeriod && I % StorePeriod == 0)
+      B.CreateStore(LeftSum, NextGlobal());
+    B.CreateBr(Join);
+
+    B.SetInsertPoint(Right);
+    Value *RightSum = B.CreateAdd(Sum, B.CreateLoad(NextGlobal()));
+    B.CreateBr(Join);
+
+    B.SetInsertPoint(Join);
+    PHINode *Phi = B.CreatePHI(I32, 2);
+    Phi->addIncoming(LeftSum, Left);
+    Phi->addIncoming(RightSum, Right);
+    Sum = B.CreateAdd(Phi, B.CreateLoad(NextGlobal()));
+  }
+  B.CreateRet(Sum);
+  return M;
+}
+
+static void setGVNMemorySSA(bool Enable) {
+  auto &Opts = cl::getRegisteredOptions();
+  static_cast<cl::opt<bool> *>(Opts["enable-gvn-memoryssa"])
+      ->setValue(Enable);
+}
+
+// Run GVN over the diamonds, with the dependencies of loads found by memdep
+// (range 2 == 0) or MemorySSA (1). The number of loads left is reported.
+static void BM_GVNLoads(benchmark::State &State) {
+  initializeScalarOpts(*PassRegistry::getPassRegistry());
+  setGVNMemorySSA(State.range(2));
+  LLVMContext Context;
+  unsigned NumLoads = 0;
+  for (auto _ : State) {
+    State.PauseTiming();
+    std::unique_ptr<Module> M =
+        createDiamondsModule(Context, State.range(0), State.range(1));
+    legacy::PassManager PM;
+    PM.add(new TargetLibraryInfoWrapperPass());
+    PM.add(createBasicAAWrapperPass());
+    PM.add(createGVNPass());
+    State.ResumeTiming();
+    PM.run(*M);
+    State.PauseTiming();
+    NumLoads = 0;
+    for (Instruction &I : instructions(M->getFunction("f")))
+      NumLoads += isa<LoadInst>(I);
+    State.ResumeTiming();
+  }
+  State.counters["loads"] = NumLoads;
+  setGVNMemorySSA(false);
+}
+// Read-only diamonds, diamonds with a store in every third one and diamonds
+// that all store.
+BENCHMARK(BM_GVNLoads)
+    ->Apply([](benchmark::internal::Benchmark *B) {
+      for (int NumDiamonds : {1000, 4000})
+        for (int StorePeriod : {0, 3, 1})
+          for (int MemorySSA : {0, 1})
+            B->Args({NumDiamonds, StorePeriod, MemorySSA});
+    })
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,94 @@
+#include "benchmark/benchmark.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/InitializePasses.h"
+#include "llvm/PassRegistry.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Transforms/IPO.h"
+#include <memory>
+
+using namespace llvm;
+
+// A module with a callee of NumBlocks blocks and NumCallers functions calling
+// it. Each block of the callee adds to a running sum and leaves early once it
+// reaches the first argument. The callers pass either distinct constants,
+// which give each call site its own summary, or the same one.
+static std::unique_ptr<Module> createCalleeModule(LLVMContext &Context,
+                                                  unsigned NumBlocks,
+                                                  unsigned NumCallers,
+                                                  bool DistinctConstants) {
+  auto M = llvm::make_unique<Module>("inlinecost", Context);
+  IntegerType *I32 = Type::getInt32Ty(Context);
+  PointerType *I32Ptr = I32->getPointerTo();
+  FunctionType *FTy = FunctionType::get(I32, {I32, I32Ptr}, false);
+
+  Function *Callee = Function::Create(FTy, GlobalValue::ExternalLinkage,
+                                      "callee", M.get());
+  Value *K = &*Callee->arg_begin();
+  Value *P = &*std::next(Callee->arg_begin());
+  BasicBlock *Exit = BasicBlock::Create(Context, "exit", Callee);
+  BasicBlock *BB = BasicBlock::Create(Context, "entry", Callee, Exit);
+  IRBuilder<> B(Exit);
+  PHINode *Result = B.CreatePHI(I32, NumBlocks);
+  B.CreateRet(Result);
+  Value *Sum = B.getInt32(0);
+  for (unsigned I = 0; I != NumBlocks; ++I) {
+    B.SetInsertPoint(BB);
+    Value *Elt = B.CreateGEP(P, B.getInt32(I));
+    Sum = B.CreateAdd(Sum, B.CreateMul(B.CreateLoad(Elt), K));
+    B.CreateStore(Sum, Elt);
+    BasicBlock *Next = BasicBlock::Create(Context, "bb", Callee, Exit);
+    B.CreateCondBr(B.CreateICmpULT(Sum, K), Next, Exit);
+    Result->addIncoming(Sum, BB);
+    BB = Next;
+  }
+  B.SetInsertPoint(BB);
+  B.CreateBr(Exit);
+  Result->addIncoming(Sum, BB);
+
+  for (unsigned I = 0; I != NumCallers; ++I) {
+    Function *Caller = Function::Create(FTy, GlobalValue::ExternalLinkage,
+                                        "caller" + Twine(I), M.get());
+    B.SetInsertPoint(BasicBlock::Create(Context, "entry", Caller));
+    unsigned C = DistinctConstants ? I + 1 : 1;
+    B.CreateRet(B.CreateCall(
+        Callee, {B.getInt32(C), &*std::next(Caller->arg_begin())}));
+  }
+  return M;
+}
+
+static void setInlineCostSummaries(bool Enable) {
+  auto &Opts = cl::getRegisteredOptions();
+  static_cast<cl::opt<bool> *>(Opts["inline-cost-summaries"])
+      ->setValue(Enable);
+}
+
+// Run the inliner over the callers of the callee, with the cost summaries
+// enabled or not.
+static void BM_Inliner(benchmark::State &State) {
+  initializeAnalysis(*PassRegistry::getPassRegistry());
+  setInlineCostSummaries(State.range(3));
+  LLVMContext Context;
+  for (auto _ : State) {
+    State.PauseTiming();
+    std::unique_ptr<Module> M = createCalleeModule(
+        Context, State.range(0), State.range(1), State.range(2));
+    legacy::PassManager PM;
+    PM.add(new TargetLibraryInfoWrapperPass());
+    PM.add(createFunctionInliningPass());
+    State.ResumeTiming();
+    PM.run(*M);
+  }
+  setInlineCostSummaries(false);
+}
+// Callees small enough to be inlined and too large to be, called with a few or
+// with many distinct constants.
+BENCHMARK(BM_Inliner)
+    ->RangeMultiplier(16)
+    ->Ranges({{4, 4096}, {256, 256}, {0, 1}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
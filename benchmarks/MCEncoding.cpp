@@ -0,0 +1,162 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/MC/MCAsmBackend.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCCodeEmitter.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/MC/MCObjectWriter.h"
+#include "llvm/MC/MCParser/MCAsmParser.h"
+#include "llvm/MC/MCParser/MCTargetAsmParser.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCStreamer.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/MCTargetOptions.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+static const char *TripleName = "x86_64-unknown-linux-gnu";
+static const char *CPUName = "haswell";
+
+// A mix of register, immediate, memory and VEX-encoded instructions without
+// symbolic operands, so that emitting them creates no fixups.
+static const char *InstructionMix = "\tmovq %rdi, %rax\n"
+                                    "\taddl $42, %ecx\n"
+                                    "\tleaq 8(%rsp,%rbx,4), %rdx\n"
+                                    "\tmovl 16(%rdi), %esi\n"
+                                    "\timulq %rsi, %rax\n"
+                                    "\tvaddps %ymm1, %ymm2, %ymm3\n"
+                                    "\tmovaps (%rax), %xmm0\n"
+                                    "\tpushq %rbp\n"
+                                    "\tshlq $3, %r8\n"
+                                    "\tcmpq %r9, %r10\n"
+                                    "\tpopq %rbp\n"
+                                    "\txorl %eax, %eax\n";
+
+namespace {
+// Collects the instructions the assembly parser produces.
+class InstRecorder : public MCStreamer {
+public:
+  std::vector<MCInst> Insts;
+
+  InstRecorder(MCContext &Ctx) : MCStreamer(Ctx) {}
+
+  void EmitInstruction(const MCInst &Inst, const MCSubtargetInfo &STI,
+                       bool PrintSchedInfo) override {
+    Insts.push_back(Inst);
+  }
+  bool EmitSymbolAttribute(MCSymbol *Symbol, MCSymbolAttr Attribute) override {
+    return true;
+  }
+  void EmitCommonSymbol(MCSymbol *Symbol, uint64_t Size,
+                        unsigned ByteAlignment) override {}
+  void EmitZerofill(MCSection *Section, MCSymbol *Symbol, uint64_t Size,
+                    unsigned ByteAlignment, SMLoc Loc) override {}
+};
+
+// The target descriptions shared by parsing and encoding.
+struct MCSetup {
+  const Target &T;
+  std::unique_ptr<MCRegisterInfo> MRI;
+  std::unique_ptr<MCAsmInfo> MAI;
+  std::unique_ptr<MCInstrInfo> MCII;
+  std::unique_ptr<MCSubtargetInfo> STI;
+  MCTargetOptions MCOptions;
+
+  MCSetup(const Target &T)
+      : T(T), MRI(T.createMCRegInfo(TripleName)),
+        MAI(T.createMCAsmInfo(*MRI, TripleName)), MCII(T.createMCInstrInfo()),
+        STI(T.createMCSubtargetInfo(TripleName, CPUName, "")) {}
+};
+} // end anonymous namespace
+
+// Parse Asm into MCInsts in Recorder, whose context must outlive them.
+static bool parse(MCSetup &S, SourceMgr &SrcMgr, InstRecorder &Recorder) {
+  std::unique_ptr<MCAsmParser> Parser(createMCAsmParser(
+      SrcMgr, Recorder.getContext(), Recorder, *S.MAI));
+  std::unique_ptr<MCTargetAsmParser> TAP(
+      S.T.createMCAsmParser(*S.STI, *Parser, *S.MCII, S.MCOptions));
+  if (!TAP)
+    return false;
+  Parser->setTargetParser(*TAP);
+  return !Parser->Run(/*NoInitialTextSection=*/false);
+}
+
+// Emit Insts through an ELF object streamer, which encodes each of them
+// into the current data fragment.
+static void encode(MCSetup &S, ArrayRef<MCInst> Insts,
+                   SmallVectorImpl<char> &Out) {
+  Triple TheTriple(TripleName);
+  MCObjectFileInfo MOFI;
+  MCContext Ctx(S.MAI.get(), S.MRI.get(), &MOFI);
+  MOFI.InitMCObjectFileInfo(TheTriple, /*PIC=*/false, Ctx);
+
+  raw_svector_ostream OS(Out);
+  MCAsmBackend *MAB = S.T.createMCAsmBackend(*S.STI, *S.MRI, S.MCOptions);
+  std::unique_ptr<MCStreamer> Str(S.T.createMCObjectStreamer(
+      TheTriple, Ctx, std::unique_ptr<MCAsmBackend>(MAB),
+      MAB->createObjectWriter(OS),
+      std::unique_ptr<MCCodeEmitter>(
+          S.T.createMCCodeEmitter(*S.MCII, *S.MRI, Ctx)),
+      *S.STI, /*RelaxAll=*/false, /*IncrementalLinkerCompatible=*/false,
+      /*DWARFMustBeAtTheEnd=*/false));
+  Str->InitSections(/*NoExecStack=*/false);
+  for (const MCInst &Inst : Insts)
+    Str->EmitInstruction(Inst, *S.STI);
+  Str->Finish();
+}
+
+static void BM_EncodeInstructions(benchmark::State &State) {
+  std::string Error;
+  const Target *T = TargetRegistry::lookupTarget(TripleName, Error);
+  if (!T) {
+    State.SkipWithError(Error.c_str());
+    return;
+  }
+  MCSetup S(*T);
+
+  std::string Asm;
+  for (int64_t I = 0, E = State.range(0); I != E; ++I)
+    Asm += InstructionMix;
+  SourceMgr SrcMgr;
+  SrcMgr.AddNewSourceBuffer(MemoryBuffer::getMemBuffer(Asm), SMLoc());
+  MCObjectFileInfo MOFI;
+  MCContext Ctx(S.MAI.get(), S.MRI.get(), &MOFI, &SrcMgr);
+  MOFI.InitMCObjectFileInfo(Triple(TripleName), /*PIC=*/false, Ctx);
+  InstRecorder Recorder(Ctx);
+  if (!parse(S, SrcMgr, Recorder)) {
+    State.SkipWithError("failed to parse");
+    return;
+  }
+
+  for (auto _ : State) {
+    SmallString<0> Out;
+    encode(S, Recorder.Insts, Out);
+    benchmark::DoNotOptimize(Out.data());
+  }
+  State.SetItemsProcessed(State.iterations() * Recorder.Insts.size());
+}
+BENCHMARK(BM_EncodeInstructions)->RangeMultiplier(8)->Range(64, 32768);
+
+int main(int argc, char **argv) {
+  InitializeAllTargetInfos();
+  InitializeAllTargetMCs();
+  InitializeAllAsmParsers();
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,116 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/MC/MCAsmBackend.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCCodeEmitter.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/MC/MCObjectWriter.h"
+#include "llvm/MC/MCParser/MCAsmParser.h"
+#include "llvm/MC/MCParser/MCTargetAsmParser.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCStreamer.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/MCTargetOptions.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include <memory>
+#include <string>
+
+using namespace llvm;
+
+static const char *TripleName = "x86_64-unknown-linux-gnu";
+
+// Assemble Asm into an ELF object in Out, the way llvm-mc -filetype=obj does.
+static bool assemble(const Target &T, const std::string &Asm,
+                     SmallVectorImpl<char> &Out) {
+  Triple TheTriple(TripleName);
+  SourceMgr SrcMgr;
+  SrcMgr.AddNewSourceBuffer(MemoryBuffer::getMemBuffer(Asm), SMLoc());
+
+  std::unique_ptr<MCRegisterInfo> MRI(T.createMCRegInfo(TripleName));
+  std::unique_ptr<MCAsmInfo> MAI(T.createMCAsmInfo(*MRI, TripleName));
+  std::unique_ptr<MCInstrInfo> MCII(T.createMCInstrInfo());
+  std::unique_ptr<MCSubtargetInfo> STI(
+      T.createMCSubtargetInfo(TripleName, "", ""));
+  MCTargetOptions MCOptions;
+
+  MCObjectFileInfo MOFI;
+  MCContext Ctx(MAI.get(), MRI.get(), &MOFI, &SrcMgr);
+  MOFI.InitMCObjectFileInfo(TheTriple, /*PIC=*/false, Ctx);
+  Ctx.setUseNamesOnTempLabels(false);
+
+  raw_svector_ostream OS(Out);
+  MCAsmBackend *MAB = T.createMCAsmBackend(*STI, *MRI, MCOptions);
+  std::unique_ptr<MCStreamer> Str(T.createMCObjectStreamer(
+      TheTriple, Ctx, std::unique_ptr<MCAsmBackend>(MAB),
+      MAB->createObjectWriter(OS),
+      std::unique_ptr<MCCodeEmitter>(T.createMCCodeEmitter(*MCII, *MRI, Ctx)),
+      *STI, /*RelaxAll=*/false, /*IncrementalLinkerCompatible=*/false,
+      /*DWARFMustBeAtTheEnd=*/false));
+
+  std::unique_ptr<MCAsmParser> Parser(
+      createMCAsmParser(SrcMgr, Ctx, *Str, *MAI));
+  std::unique_ptr<MCTargetAsmParser> TAP(
+      T.createMCAsmParser(*STI, *Parser, *MCII, MCOptions));
+  if (!TAP)
+    return false;
+  Parser->setTargetParser(*TAP);
+  return !Parser->Run(/*NoInitialTextSection=*/false);
+}
+
+// NumBlocks blocks, each with a conditional branch a few blocks ahead and some
+// filler. The branches start out short, and each one that grows pushes the
+// targets of the branches before it further away, so relaxation takes several
+// iterations over a section with many relaxable fragments.
+static std::string createBranchyAsm(unsigned NumBlocks) {
+  std::string Asm = "\t.text\n";
+  raw_string_ostream OS(Asm);
+  for (unsigned I = 0; I != NumBlocks; ++I) {
+    OS << ".LBB" << I << ":\n";
+    OS << "\tcmpl $" << I % 7 << ", %eax\n";
+    OS << "\tjne .LBB" << I + 8 << "\n";
+    for (unsigned J = 0; J != I % 4; ++J)
+      OS << "\taddl %ecx, %eax\n";
+  }
+  for (unsigned I = NumBlocks; I != NumBlocks + 8; ++I)
+    OS << ".LBB" << I << ":\n";
+  OS << "\tretq\n";
+  return OS.str();
+}
+
+static void BM_AssembleRelaxation(benchmark::State &State) {
+  std::string Error;
+  const Target *T = TargetRegistry::lookupTarget(TripleName, Error);
+  if (!T) {
+    State.SkipWithError(Error.c_str());
+    return;
+  }
+  std::string Asm = createBranchyAsm(State.range(0));
+  for (auto _ : State) {
+    SmallString<0> Out;
+    if (!assemble(*T, Asm, Out)) {
+      State.SkipWithError("failed to assemble");
+      return;
+    }
+    benchmark::DoNotOptimize(Out.data());
+  }
+  State.SetBytesProcessed(State.iterations() * Asm.size());
+}
+BENCHMARK(BM_AssembleRelaxation)->RangeMultiplier(8)->Range(512, 262144);
+
+int main(int argc, char **argv) {
+  InitializeAllTargetInfos();
+  InitializeAllTargetMCs();
+  InitializeAllAsmParsers();
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+  benchmark::RunSpecifiedBenchmarks();
+}
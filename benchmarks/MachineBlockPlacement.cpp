@@ -0,0 +1,126 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Target/TargetOptions.h"
+#include <memory>
+
+using namespace llvm;
+
+static const char *TripleName = "x86_64-unknown-linux-gnu";
+
+// An interpreter loop. The header loads an opcode and dispatches on it with a
+// switch of NumCases cases. Each case stores a constant and goes back to the
+// header. All the cases are equally hot, so once the header is placed
+// thousands of blocks are candidates for the next one.
+static std::unique_ptr<Module> createInterpreterModule(LLVMContext &Context,
+                                                       unsigned NumCases) {
+  auto M = llvm::make_unique<Module>("interpreter", Context);
+  M->setTargetTriple(TripleName);
+  IntegerType *I32 = Type::getInt32Ty(Context);
+  PointerType *I32Ptr = I32->getPointerTo();
+  FunctionType *FTy = FunctionType::get(Type::getVoidTy(Context),
+                                        {I32Ptr, I32, I32Ptr}, false);
+  Function *F = Function::Create(FTy, GlobalValue::ExternalLinkage,
+                                 "interpret", M.get());
+  auto AI = F->arg_begin();
+  Value *Code = &*AI++;
+  Value *Size = &*AI++;
+  Value *Out = &*AI;
+
+  BasicBlock *Entry = BasicBlock::Create(Context, "entry", F);
+  BasicBlock *Dispatch = BasicBlock::Create(Context, "dispatch", F);
+  BasicBlock *Next = BasicBlock::Create(Context, "next", F);
+  BasicBlock *Exit = BasicBlock::Create(Context, "exit", F);
+  IRBuilder<> B(Entry);
+  B.CreateBr(Dispatch);
+
+  B.SetInsertPoint(Dispatch);
+  PHINode *PC = B.CreatePHI(I32, 2, "pc");
+  SwitchInst *SI =
+      B.CreateSwitch(B.CreateLoad(B.CreateGEP(Code, PC)), Exit, NumCases);
+
+  B.SetInsertPoint(Next);
+  Value *NextPC = B.CreateAdd(PC, B.getInt32(1));
+  B.CreateCondBr(B.CreateICmpULT(NextPC, Size), Dispatch, Exit);
+  PC->addIncoming(B.getInt32(0), Entry);
+  PC->addIncoming(NextPC, Next);
+
+  for (unsigned I = 0; I != NumCases; ++I) {
+    BasicBlock *Case = BasicBlock::Create(Context, "op", F, Next);
+    SI->addCase(B.getInt32(I), Case);
+    B.SetInsertPoint(Case);
+    B.CreateStore(B.getInt32(I), Out);
+    B.CreateBr(Next);
+  }
+
+  B.SetInsertPoint(Exit);
+  B.CreateRetVoid();
+  return M;
+}
+
+// Compile the interpreter loop to an object file, with block placement
+// disabled (range 1 == 0) or enabled (range 1 == 1). The difference is the
+// time spent laying out the blocks.
+static void BM_CodeGenInterpreter(benchmark::State &State) {
+  std::string Error;
+  const Target *T = TargetRegistry::lookupTarget(TripleName, Error);
+  if (!T) {
+    State.SkipWithError(Error.c_str());
+    return;
+  }
+  auto *DisablePlacement = static_cast<cl::opt<bool> *>(
+      cl::getRegisteredOptions()["disable-block-placement"]);
+  if (!DisablePlacement) {
+    State.SkipWithError("no -disable-block-placement option");
+    return;
+  }
+  DisablePlacement->setValue(State.range(1) == 0);
+
+  std::unique_ptr<TargetMachine> TM(T->createTargetMachine(
+      TripleName, "", "", TargetOptions(), None, None, CodeGenOpt::Default));
+  LLVMContext Context;
+  for (auto _ : State) {
+    State.PauseTiming();
+    std::unique_ptr<Module> M =
+        createInterpreterModule(Context, State.range(0));
+    M->setDataLayout(TM->createDataLayout());
+    SmallString<0> Out;
+    raw_svector_ostream OS(Out);
+    legacy::PassManager PM;
+    PM.add(new TargetLibraryInfoWrapperPass(Triple(TripleName)));
+    if (TM->addPassesToEmitFile(PM, OS, nullptr,
+                                TargetMachine::CGFT_ObjectFile)) {
+      State.SkipWithError("cannot emit an object file");
+      break;
+    }
+    State.ResumeTiming();
+    PM.run(*M);
+  }
+  DisablePlacement->setValue(false);
+}
+BENCHMARK(BM_CodeGenInterpreter)
+    ->RangeMultiplier(4)
+    ->Ranges({{256, 16384}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char **argv) {
+  InitializeAllTargetInfos();
+  InitializeAllTargets();
+  InitializeAllTargetMCs();
+  InitializeAllAsmPrinters();
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,87 @@
+#include "benchmark/benchmark.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/Utils/FunctionComparator.h"
+#include <memory>
+#include <random>
+
+using namespace llvm;
+
+// A module with NumFuncs functions that look like instantiations of a few
+// templates. The functions of a template have the same instructions, but most
+// of them differ in a constant or in the function they call, so they only
+// share functionHash. About one in four is a copy of another one.
+static std::unique_ptr<Module> createTemplateModule(LLVMContext &Context,
+                                                    unsigned NumFuncs) {
+  const unsigned NumTemplates = 16;
+  const unsigned NumCallees = 8;
+
+  auto M = llvm::make_unique<Module>("mergefunc", Context);
+  IntegerType *I32 = Type::getInt32Ty(Context);
+  FunctionType *FTy = FunctionType::get(I32, {I32, I32}, false);
+
+  std::vector<Function *> Callees;
+  for (unsigned I = 0; I != NumCallees; ++I)
+    Callees.push_back(Function::Create(FTy, GlobalValue::ExternalLinkage,
+                                       "callee" + Twine(I), M.get()));
+
+  std::mt19937 Rand(0);
+  for (unsigned I = 0; I != NumFuncs; ++I) {
+    unsigned Template = Rand() % NumTemplates;
+    // Copies draw from a small set of variants, the others from a large one.
+    unsigned Variant = Rand() % 4 == 0 ? Rand() % 4 : Rand();
+    Function *F = Function::Create(FTy, GlobalValue::ExternalLinkage,
+                                   "f" + Twine(I), M.get());
+    IRBuilder<> B(BasicBlock::Create(Context, "entry", F));
+    Value *X = &*F->arg_begin();
+    Value *Y = &*std::next(F->arg_begin());
+    for (unsigned J = 0; J != 4 + Template; ++J) {
+      switch ((Template + J) % 3) {
+      case 0:
+        X = B.CreateAdd(X, B.getInt32(Variant % 1024 + J));
+        break;
+      case 1:
+        X = B.CreateMul(X, Y);
+        break;
+      case 2:
+        Y = B.CreateCall(Callees[Variant / 1024 % NumCallees], {X, Y});
+        break;
+      }
+    }
+    B.CreateRet(B.CreateXor(X, Y));
+  }
+  return M;
+}
+
+static void BM_MergeFunctions(benchmark::State &State) {
+  LLVMContext Context;
+  for (auto _ : State) {
+    State.PauseTiming();
+    std::unique_ptr<Module> M = createTemplateModule(Context, State.range(0));
+    legacy::PassManager PM;
+    PM.add(createMergeFunctionsPass());
+    State.ResumeTiming();
+    PM.run(*M);
+  }
+}
+BENCHMARK(BM_MergeFunctions)->RangeMultiplier(8)->Range(256, 131072);
+
+// Hashing the whole module, to compare the cost of the two hashes.
+template <FunctionComparator::FunctionHash (*Hash)(Function &)>
+static void BM_Hash(benchmark::State &State) {
+  LLVMContext Context;
+  std::unique_ptr<Module> M = createTemplateModule(Context, State.range(0));
+  for (auto _ : State)
+    for (Function &F : *M)
+      if (!F.isDeclaration())
+        benchmark::DoNotOptimize(Hash(F));
+}
+BENCHMARK_TEMPLATE(BM_Hash, FunctionComparator::functionHash)
+    ->Arg(16384);
+BENCHMARK_TEMPLATE(BM_Hash, FunctionComparator::functionFingerprint)
+    ->Arg(16384);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,214 @@
+#include "benchmark/benchmark.h"
+#include "llvm/CodeGen/LiveIntervals.h"
+#include "llvm/CodeGen/MIRParser/MIRParser.h"
+#include "llvm/CodeGen/MachineFunction.h"
+#include "llvm/CodeGen/MachineFunctionPass.h"
+#include "llvm/CodeGen/MachineModuleInfo.h"
+#include "llvm/CodeGen/RegisterClassInfo.h"
+#include "llvm/CodeGen/RegisterPressure.h"
+#include "llvm/CodeGen/TargetSubtargetInfo.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/InitializePasses.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Target/TargetOptions.h"
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+static const char *TripleName = "x86_64-unknown-linux-gnu";
+
+// Count the heap allocations made by the queries.
+static size_t NumAllocations = 0;
+
+void *operator new(size_t Size) {
+  ++NumAllocations;
+  if (void *P = std::malloc(Size ? Size : 1))
+    return P;
+  report_bad_alloc_error("operator new failed");
+}
+
+void operator delete(void *P) noexcept { std::free(P); }
+
+// A block of NumValues independent 32-bit adds that are then summed up, so
+// that all of them are live at once in the middle of the block and the
+// general purpose register pressure set is well past its limit.
+static std::string createPressureMIR(unsigned NumValues) {
+  std::string MIR;
+  raw_string_ostream OS(MIR);
+  OS << "---\n"
+        "name: pressure\n"
+        "tracksRegLiveness: true\n"
+        "body: |\n"
+        "  bb.0:\n"
+        "    liveins: $edi\n"
+        "    %0:gr32 = COPY $edi\n";
+  for (unsigned I = 1; I <= NumValues; ++I)
+    OS << "    %" << I << ":gr32 = ADD32ri %0, " << I
+       << ", implicit-def dead $eflags\n";
+  unsigned Sum = 1;
+  for (unsigned I = 2; I <= NumValues; ++I) {
+    unsigned NewSum = NumValues + I;
+    OS << "    %" << NewSum << ":gr32 = ADD32rr %" << Sum << ", %" << I
+       << ", implicit-def dead $eflags\n";
+    Sum = NewSum;
+  }
+  OS << "    $eax = COPY %" << Sum << "\n"
+        "    RET 0, $eax\n"
+        "...\n";
+  return OS.str();
+}
+
+namespace {
+enum PressureQuery { MaxUpward, Upward, MaxDownward };
+
+// Position a pressure tracker in the middle of the block the way the machine
+// scheduler's bottom-up or top-down tracker would be, and time the delta
+// query it makes for every ready candidate.
+struct PressureDeltaPass : public MachineFunctionPass {
+  static char ID;
+  benchmark::State &State;
+  PressureQuery Query;
+
+  PressureDeltaPass(benchmark::State &State, PressureQuery Query)
+      : MachineFunctionPass(ID), State(State), Query(Query) {}
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.setPreservesAll();
+    AU.addRequired<LiveIntervals>();
+    MachineFunctionPass::getAnalysisUsage(AU);
+  }
+
+  bool runOnMachineFunction(MachineFunction &MF) override {
+    LiveIntervals &LIS = getAnalysis<LiveIntervals>();
+    const TargetRegisterInfo &TRI = *MF.getSubtarget().getRegisterInfo();
+    const MachineRegisterInfo &MRI = MF.getRegInfo();
+    RegisterClassInfo RCI;
+    RCI.runOnMachineFunction(MF);
+
+    std::vector<unsigned> MaxPressureLimit;
+    for (unsigned PSet = 0, E = TRI.getNumRegPressureSets(); PSet != E; ++PSet)
+      MaxPressureLimit.push_back(RCI.getRegPressureSetLimit(PSet));
+
+    MachineBasicBlock &MBB = MF.front();
+    std::vector<MachineInstr *> Instrs;
+    for (MachineInstr &MI : MBB)
+      Instrs.push_back(&MI);
+    unsigned Mid = Instrs.size() / 2;
+
+    IntervalPressure Pressure;
+    RegPressureTracker Tracker(Pressure);
+    std::vector<MachineInstr *> Candidates;
+    if (Query == MaxDownward) {
+      Tracker.init(&MF, &RCI, &LIS, &MBB, MBB.begin(), false, false);
+      for (unsigned I = 0; I != Mid; ++I)
+        Tracker.advance();
+      Candidates.assign(Instrs.begin() + Mid, Instrs.end() - 1);
+    } else {
+      Tracker.init(&MF, &RCI, &LIS, &MBB, MBB.end(), false, true);
+      for (unsigned I = Instrs.size(); I != Mid; --I)
+        Tracker.recede();
+      Candidates.assign(Instrs.begin(), Instrs.begin() + Mid);
+    }
+
+    PressureDiffs PDiffs;
+    PDiffs.init(Candidates.size());
+    for (unsigned I = 0, E = Candidates.size(); I != E; ++I) {
+      RegisterOperands RegOpers;
+      RegOpers.collect(*Candidates[I], TRI, MRI, false, false);
+      PDiffs.addInstruction(I, RegOpers, MRI);
+    }
+
+    size_t StartAllocations = NumAllocations;
+    for (auto _ : State) {
+      for (unsigned I = 0, E = Candidates.size(); I != E; ++I) {
+        RegPressureDelta Delta;
+        switch (Query) {
+        case MaxUpward:
+          Tracker.getMaxUpwardPressureDelta(Candidates[I], nullptr, Delta,
+                                            None, MaxPressureLimit);
+          break;
+        case Upward:
+          Tracker.getUpwardPressureDelta(Candidates[I], PDiffs[I], Delta,
+                                         None, MaxPressureLimit);
+          break;
+        case MaxDownward:
+          Tracker.getMaxDownwardPressureDelta(Candidates[I], Delta, None,
+                                              MaxPressureLimit);
+          break;
+        }
+        benchmark::DoNotOptimize(Delta);
+      }
+    }
+    size_t NumQueries = State.iterations() * Candidates.size();
+    State.SetItemsProcessed(NumQueries);
+    State.counters["allocs/query"] =
+        double(NumAllocations - StartAllocations) / NumQueries;
+    return false;
+  }
+};
+} // end anonymous namespace
+
+char PressureDeltaPass::ID = 0;
+
+// Query the pressure delta of every instruction in the unscheduled half of a
+// block of NumValues values (range 0), bottom-up with the snapshotting query
+// (range 1 == 0), bottom-up with the cached PressureDiff (1) or top-down (2).
+static void BM_PressureDelta(benchmark::State &State) {
+  std::string Error;
+  const Target *T = TargetRegistry::lookupTarget(TripleName, Error);
+  if (!T) {
+    State.SkipWithError(Error.c_str());
+    return;
+  }
+  std::unique_ptr<TargetMachine> TM(T->createTargetMachine(
+      TripleName, "", "", TargetOptions(), None, None, CodeGenOpt::Default));
+
+  LLVMContext Context;
+  std::unique_ptr<MIRParser> MIR =
+      createMIRParser(MemoryBuffer::getMemBufferCopy(
+                          createPressureMIR(State.range(0))),
+                      Context);
+  std::unique_ptr<Module> M = MIR ? MIR->parseIRModule() : nullptr;
+  if (!M) {
+    State.SkipWithError("cannot parse the MIR");
+    return;
+  }
+  M->setDataLayout(TM->createDataLayout());
+  auto *MMI = new MachineModuleInfo(TM.get());
+  legacy::PassManager PM;
+  PM.add(MMI);
+  if (MIR->parseMachineFunctions(*M, *MMI)) {
+    State.SkipWithError("cannot parse the machine functions");
+    return;
+  }
+  PM.add(new PressureDeltaPass(State,
+                               static_cast<PressureQuery>(State.range(1))));
+  PM.run(*M);
+}
+BENCHMARK(BM_PressureDelta)->Apply([](benchmark::internal::Benchmark *B) {
+  for (int NumValues : {8, 64, 512})
+    for (int Query : {MaxUpward, Upward, MaxDownward})
+      B->Args({NumValues, Query});
+});
+
+int main(int argc, char **argv) {
+  InitializeAllTargetInfos();
+  InitializeAllTargets();
+  InitializeAllTargetMCs();
+  initializeCodeGen(*PassRegistry::getPassRegistry());
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,231 @@
+#include "benchmark/benchmark.h"
+#include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+
+using namespace llvm;
+
+namespace {
+
+// A function with a chain of NumLoops loops, each with a two-deep nest. The
+// trip counts of all the loops are derived from the same argument, and every
+// nest carries a few induction variables, so the backedge-taken counts and
+// add recurrences share subexpressions the way they do in numeric code.
+struct LoopHeavyFunction {
+  LLVMContext Context;
+  Module M{"scev", Context};
+  Function *F;
+  Instruction *Bound;
+
+  explicit LoopHeavyFunction(unsigned NumLoops) {
+    IntegerType *I64 = Type::getInt64Ty(Context);
+    F = Function::Create(FunctionType::get(Type::getVoidTy(Context),
+                                           {I64, I64->getPointerTo()}, false),
+                         GlobalValue::ExternalLinkage, "f", &M);
+    Argument *N = &*F->arg_begin();
+    Argument *Ptr = &*std::next(F->arg_begin());
+
+    BasicBlock *Entry = BasicBlock::Create(Context, "entry", F);
+    IRBuilder<> B(Entry);
+    Bound = cast<Instruction>(B.CreateMul(N, B.getInt64(3), "bound"));
+
+    BasicBlock *Pred = Entry;
+    for (unsigned I = 0; I != NumLoops; ++I) {
+      BasicBlock *Outer = BasicBlock::Create(Context, "outer", F);
+      BasicBlock *Inner = BasicBlock::Create(Context, "inner", F);
+      BasicBlock *Latch = BasicBlock::Create(Context, "latch", F);
+      BasicBlock *Next = BasicBlock::Create(Context, "next", F);
+      B.SetInsertPoint(Pred);
+      B.CreateBr(Outer);
+
+      B.SetInsertPoint(Outer);
+      PHINode *OuterIV = B.CreatePHI(I64, 2, "i");
+      Value *Limit = B.CreateAdd(Bound, B.getInt64(I), "limit");
+      B.CreateBr(Inner);
+
+      B.SetInsertPoint(Inner);
+      PHINode *InnerIV = B.CreatePHI(I64, 2, "j");
+      PHINode *Offset = B.CreatePHI(I64, 2, "off");
+      Value *Index = B.CreateAdd(B.CreateMul(OuterIV, Limit), InnerIV);
+      Value *Addr = B.CreateGEP(Ptr, B.CreateAdd(Index, Offset));
+      B.CreateStore(Index, Addr);
+      Value *InnerNext = B.CreateAdd(InnerIV, B.getInt64(1), "", false, true);
+      Value *OffsetNext = B.CreateAdd(Offset, B.getInt64(4), "", false, true);
+      B.CreateCondBr(B.CreateICmpSLT(InnerNext, Limit), Inner, Latch);
+      InnerIV->addIncoming(B.getInt64(0), Outer);
+      InnerIV->addIncoming(InnerNext, Inner);
+      Offset->addIncoming(B.getInt64(I), Outer);
+      Offset->addIncoming(OffsetNext, Inner);
+
+      B.SetInsertPoint(Latch);
+      Value *OuterNext = B.CreateAdd(OuterIV, B.getInt64(1), "", false, true);
+      B.CreateCondBr(B.CreateICmpSLT(OuterNext, N), Outer, Next);
+      OuterIV->addIncoming(B.getInt64(0), Pred);
+      OuterIV->addIncoming(OuterNext, Latch);
+      Pred = Next;
+    }
+
+    B.SetInsertPoint(Pred);
+    B.CreateRetVoid();
+  }
+};
+
+// A function with NumArgs i64 arguments and a single loop, so expressions can
+// be built from distinct SCEVUnknowns and add recurrences.
+struct ArgumentsFunction {
+  LLVMContext Context;
+  Module M{"scev", Context};
+  Function *F;
+  PHINode *IV;
+
+  explicit ArgumentsFunction(unsigned NumArgs) {
+    IntegerType *I64 = Type::getInt64Ty(Context);
+    SmallVector<Type *, 64> Params(NumArgs, I64);
+    F = Function::Create(
+        FunctionType::get(Type::getVoidTy(Context), Params, false),
+        GlobalValue::ExternalLinkage, "f", &M);
+    BasicBlock *Entry = BasicBlock::Create(Context, "entry", F);
+    BasicBlock *Loop = BasicBlock::Create(Context, "loop", F);
+    BasicBlock *Exit = BasicBlock::Create(Context, "exit", F);
+    IRBuilder<> B(Entry);
+    B.CreateBr(Loop);
+    B.SetInsertPoint(Loop);
+    IV = B.CreatePHI(I64, 2, "iv");
+    Value *Next = B.CreateAdd(IV, B.getInt64(1), "iv.next", false, true);
+    B.CreateCondBr(B.CreateICmpSLT(Next, &*F->arg_begin()), Loop, Exit);
+    IV->addIncoming(B.getInt64(0), Entry);
+    IV->addIncoming(Next, Loop);
+    B.SetInsertPoint(Exit);
+    B.CreateRetVoid();
+  }
+};
+
+// The analyses ScalarEvolution depends on.
+struct SCEVAnalyses {
+  TargetLibraryInfoImpl TLII;
+  TargetLibraryInfo TLI{TLII};
+  AssumptionCache AC;
+  DominatorTree DT;
+  LoopInfo LI;
+  ScalarEvolution SE;
+
+  explicit SCEVAnalyses(Function &F)
+      : AC(F), DT(F), LI(DT), SE(F, TLI, AC, DT, LI) {}
+
+  void computeAll(Function &F) {
+    for (Loop *L : LI.getLoopsInPreorder())
+      benchmark::DoNotOptimize(SE.getBackedgeTakenCount(L));
+    for (Instruction &I : instructions(F))
+      if (SE.isSCEVable(I.getType()))
+        benchmark::DoNotOptimize(SE.getSCEV(&I));
+  }
+};
+
+} // end anonymous namespace
+
+// Forget and recompute every loop in turn, the way loop passes that rewrite
+// one loop at a time invalidate ScalarEvolution.
+static void BM_SCEVForgetLoop(benchmark::State &State) {
+  LoopHeavyFunction Fn(State.range(0));
+  for (auto _ : State) {
+    SCEVAnalyses A(*Fn.F);
+    A.computeAll(*Fn.F);
+    for (Loop *L : A.LI.getLoopsInPreorder()) {
+      A.SE.forgetLoop(L);
+      benchmark::DoNotOptimize(A.SE.getBackedgeTakenCount(L));
+    }
+  }
+}
+BENCHMARK(BM_SCEVForgetLoop)->RangeMultiplier(4)->Range(4, 256);
+
+// Forget a value that every trip count is derived from.
+static void BM_SCEVForgetValue(benchmark::State &State) {
+  LoopHeavyFunction Fn(State.range(0));
+  for (auto _ : State) {
+    SCEVAnalyses A(*Fn.F);
+    A.computeAll(*Fn.F);
+    for (unsigned I = 0; I != 8; ++I) {
+      A.SE.forgetValue(Fn.Bound);
+      A.computeAll(*Fn.F);
+    }
+  }
+}
+BENCHMARK(BM_SCEVForgetValue)->RangeMultiplier(4)->Range(4, 256);
+
+// Build the sums of sliding windows of arguments, with each window given in
+// reverse order, so the operands have to be sorted. After the first pass every
+// sum already exists.
+static void BM_SCEVAddExpr(benchmark::State &State) {
+  const unsigned NumArgs = 64, Width = State.range(0);
+  ArgumentsFunction Fn(NumArgs);
+  SCEVAnalyses A(*Fn.F);
+  SmallVector<const SCEV *, 64> Args;
+  for (Argument &Arg : Fn.F->args())
+    Args.push_back(A.SE.getSCEV(&Arg));
+  const SCEV *One = A.SE.getOne(Args[0]->getType());
+  for (auto _ : State) {
+    for (unsigned I = 0; I + Width <= NumArgs; ++I) {
+      SmallVector<const SCEV *, 16> Ops(Args.rbegin() + I,
+                                        Args.rbegin() + I + Width);
+      Ops.push_back(One);
+      benchmark::DoNotOptimize(A.SE.getAddExpr(Ops));
+    }
+  }
+}
+BENCHMARK(BM_SCEVAddExpr)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+
+// The same with products.
+static void BM_SCEVMulExpr(benchmark::State &State) {
+  const unsigned NumArgs = 64, Width = State.range(0);
+  ArgumentsFunction Fn(NumArgs);
+  SCEVAnalyses A(*Fn.F);
+  SmallVector<const SCEV *, 64> Args;
+  for (Argument &Arg : Fn.F->args())
+    Args.push_back(A.SE.getSCEV(&Arg));
+  for (auto _ : State) {
+    for (unsigned I = 0; I + Width <= NumArgs; ++I) {
+      SmallVector<const SCEV *, 16> Ops(Args.rbegin() + I,
+                                        Args.rbegin() + I + Width);
+      benchmark::DoNotOptimize(A.SE.getMulExpr(Ops));
+    }
+  }
+}
+BENCHMARK(BM_SCEVMulExpr)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+
+// Arithmetic on add recurrences, as done when rewriting induction variables:
+// offsets, scaling and differences of {0,+,1}.
+static void BM_SCEVAddRecArithmetic(benchmark::State &State) {
+  const unsigned NumArgs = 64;
+  ArgumentsFunction Fn(NumArgs);
+  SCEVAnalyses A(*Fn.F);
+  const SCEV *IV = A.SE.getSCEV(Fn.IV);
+  SmallVector<const SCEV *, 64> Args;
+  for (Argument &Arg : Fn.F->args())
+    Args.push_back(A.SE.getSCEV(&Arg));
+  for (auto _ : State) {
+    for (unsigned I = 0; I + 1 < NumArgs; ++I) {
+      const SCEV *Offset = A.SE.getAddExpr(IV, Args[I]);
+      const SCEV *Scaled = A.SE.getMulExpr(Offset, Args[I + 1]);
+      benchmark::DoNotOptimize(A.SE.getMinusSCEV(Scaled, Offset));
+    }
+  }
+}
+BENCHMARK(BM_SCEVAddRecArithmetic);
+
+// Compute every SCEV and trip count of a chain of loop nests from scratch.
+static void BM_SCEVLoopNests(benchmark::State &State) {
+  LoopHeavyFunction Fn(State.range(0));
+  for (auto _ : State) {
+    SCEVAnalyses A(*Fn.F);
+    A.computeAll(*Fn.F);
+  }
+}
+BENCHMARK(BM_SCEVLoopNests)->RangeMultiplier(4)->Range(4, 256);
+
+BENCHMARK_MAIN();
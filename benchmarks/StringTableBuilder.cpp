@@ -0,0 +1,58 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/MC/StringTableBuilder.h"
+#include "llvm/Support/CommandLine.h"
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+// Mangled-looking names, like the symbol names of a large object file. Most
+// of them end in one of a few method names and parameter lists, so the
+// distribution of their last characters is very uneven.
+static std::vector<std::string> createStrings(unsigned NumStrings) {
+  static const char *const Methods[] = {"3foo", "3get", "4size", "5begin",
+                                        "3end", "7getName", "C2", "D2"};
+  static const char *const Params[] = {"Ev",  "Ev",    "Ev",  "Ev",
+                                       "Ei",  "Ej",    "Em",  "EPKc",
+                                       "EPv", "ERKS0_", "ERKNS_9StringRefE",
+                                       "EjPKc"};
+  std::vector<std::string> Strings;
+  Strings.reserve(NumStrings);
+  for (unsigned I = 0; I != NumStrings; ++I) {
+    unsigned N = I * 7919 % 1000003;
+    std::string Class = "C" + std::to_string(N);
+    Strings.push_back("_ZN4llvm" + std::to_string(Class.size()) + Class +
+                      Methods[N % 8] + Params[N / 8 % 12]);
+  }
+  return Strings;
+}
+
+// Build and tail-merge an ELF string table, with the strings sorted serially
+// (range 1 == 0) or, for tables large enough, concurrently (range 1 == 1).
+static void BM_FinalizeELF(benchmark::State &State) {
+  std::vector<std::string> Strings = createStrings(State.range(0));
+  auto *ParallelSort = static_cast<cl::opt<bool> *>(
+      cl::getRegisteredOptions()["parallel-sort-string-tables"]);
+  if (!ParallelSort) {
+    State.SkipWithError("no -parallel-sort-string-tables option");
+    return;
+  }
+  ParallelSort->setValue(State.range(1) != 0);
+
+  for (auto _ : State) {
+    StringTableBuilder B(StringTableBuilder::ELF);
+    for (const std::string &S : Strings)
+      B.add(S);
+    B.finalize();
+    benchmark::DoNotOptimize(B.getSize());
+  }
+  ParallelSort->setValue(true);
+  State.SetItemsProcessed(State.iterations() * Strings.size());
+}
+BENCHMARK(BM_FinalizeELF)
+    ->RangeMultiplier(4)
+    ->Ranges({{1 << 14, 1 << 20}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
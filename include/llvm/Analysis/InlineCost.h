@@ -14,9 +14,13 @@
 #ifndef LLVM_ANALYSIS_INLINECOST_H
 #define LLVM_ANALYSIS_INLINECOST_H
 
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Analysis/AssumptionCache.h"
 #include "llvm/Analysis/CallGraphSCCPass.h"
 #include "llvm/Analysis/OptimizationRemarkEmitter.h"
+#include "llvm/IR/PassManager.h"
+#include "llvm/IR/ValueHandle.h"
 #include <cassert>
 #include <climits>
 
@@ -182,6 +186,108 @@ struct InlineParams {
   Optional<bool> ComputeFullInlineCost;
 };
 
+/// The results of walking the body of one callee in the inline cost analysis,
+/// one for each combination of argument properties seen at its call sites.
+///
+/// What the walk finds only depends on the callee body and on what the call
+/// site tells about the arguments, so it can be reused for other call sites
+/// that agree on the latter. The threshold and the cost adjustments that depend
+/// on the call site itself are applied on top of it for each call site. The
+/// summaries describe the body as it was when they were computed: they must be
+/// cleared whenever it is modified.
+class InlineCostSummaries {
+public:
+  /// What a call site tells the analysis about one argument of the callee.
+  /// Constants are held by weak handles so that a summary can not be mistaken
+  /// for one of a constant allocated in the place of a deleted one.
+  struct ArgumentInfo {
+    /// The argument, if it is a constant.
+    WeakVH C;
+    bool IsConstant = false;
+    /// For pointers with a constant offset from their base pointer, the
+    /// offset, and either the base if it is a constant or the index of the
+    /// first argument with the same base.
+    bool IsPointer = false;
+    WeakVH ConstantBase;
+    unsigned BaseIndex = 0;
+    APInt Offset;
+    /// True if the base pointer is an alloca in the caller.
+    bool BaseIsAlloca = false;
+    /// True if the argument has the nonnull attribute at the call site.
+    bool NonNull = false;
+
+    bool operator==(const ArgumentInfo &Other) const {
+      return IsConstant == Other.IsConstant && C == Other.C &&
+             IsPointer == Other.IsPointer &&
+             ConstantBase == Other.ConstantBase &&
+             BaseIndex == Other.BaseIndex &&
+             (!IsPointer || Offset == Other.Offset) &&
+             BaseIsAlloca == Other.BaseIsAlloca && NonNull == Other.NonNull;
+    }
+  };
+
+  struct Key {
+    SmallVector<ArgumentInfo, 4> Args;
+    /// True if the caller calls itself.
+    bool CallerIsRecursive = false;
+
+    bool operator==(const Key &Other) const {
+      return CallerIsRecursive == Other.CallerIsRecursive &&
+             Args == Other.Args;
+    }
+  };
+
+  /// Why the walk of the body stopped, if it did.
+  enum FailureKind { NoFailure, UninlinablePattern, RecursiveStackSize, Other };
+
+  struct Summary {
+    /// The cost of the instructions walked.
+    int Cost = 0;
+    /// The largest cost, relative to the start of the walk, at which it would
+    /// have stopped if the threshold was exceeded: while only blocks with a
+    /// single successor were seen, and after that.
+    int64_t MaxCheckedCostSingleBB = 0;
+    int64_t MaxCheckedCostMultiBB = INT_MIN;
+    unsigned NumInstructions = 0;
+    unsigned NumVectorInstructions = 0;
+    bool SingleBB = true;
+    bool ContainsNoDuplicateCall = false;
+    /// True if the walk stopped when the cost passed the largest threshold a
+    /// call site is expected to have. The summary then only tells which check
+    /// fails for call sites with a threshold up to that limit.
+    bool CostLimitExceeded = false;
+    FailureKind Failure = NoFailure;
+    const char *FailureMessage = nullptr;
+  };
+
+  /// Return the summary for \p K, or null if there is none.
+  const Summary *lookup(const Key &K) const;
+
+  /// Record the summary for \p K. Returns the stored summary.
+  const Summary &insert(Key K, const Summary &S);
+
+  void clear() { Entries.clear(); }
+  bool empty() const { return Entries.empty(); }
+
+private:
+  SmallVector<std::pair<Key, Summary>, 2> Entries;
+};
+
+/// Analysis pass providing the inline cost summaries of a function. They start
+/// out empty and are filled in by the inliner as it evaluates call sites of the
+/// function, and are dropped along with the other analyses of the function
+/// when it is modified.
+class InlineCostSummaryAnalysis
+    : public AnalysisInfoMixin<InlineCostSummaryAnalysis> {
+  friend AnalysisInfoMixin<InlineCostSummaryAnalysis>;
+  static AnalysisKey Key;
+
+public:
+  using Result = InlineCostSummaries;
+
+  Result run(Function &F, FunctionAnalysisManager &AM) { return Result(); }
+};
+
 /// Generate the parameters to tune the inline cost analysis based only on the
 /// commandline options.
 InlineParams getInlineParams();
@@ -213,12 +319,15 @@ int getCallsiteCost(CallSite CS, const DataLayout &DL);
 /// sufficiently low to warrant inlining.
 ///
 /// Also note that calling this function *dynamically* computes the cost of
-/// inlining the callsite. It is an expensive, heavyweight call.
+/// inlining the callsite. It is an expensive, heavyweight call, unless
+/// \p CalleeSummaries, the summaries of the callee, already holds one for call
+/// sites like this one. If it does not, the one computed is added to it.
 InlineCost getInlineCost(
     CallSite CS, const InlineParams &Params, TargetTransformInfo &CalleeTTI,
     std::function<AssumptionCache &(Function &)> &GetAssumptionCache,
     Optional<function_ref<BlockFrequencyInfo &(Function &)>> GetBFI,
-    ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE = nullptr);
+    ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE = nullptr,
+    InlineCostSummaries *CalleeSummaries = nullptr);
 
 /// Get an InlineCost with the callee explicitly specified.
 /// This allows you to calculate the cost of inlining a function via a
@@ -230,7 +339,8 @@ getInlineCost(CallSite CS, Function *Callee, const InlineParams &Params,
               TargetTransformInfo &CalleeTTI,
               std::function<AssumptionCache &(Function &)> &GetAssumptionCache,
               Optional<function_ref<BlockFrequencyInfo &(Function &)>> GetBFI,
-              ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE);
+              ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE,
+              InlineCostSummaries *CalleeSummaries = nullptr);
 
 /// Minimal filter to detect invalid constructs for inlining.
 bool isInlineViable(Function &Callee);
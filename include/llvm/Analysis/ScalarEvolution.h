@@ -1319,9 +1319,10 @@ private:
     /// value returned by getMax or zero.
     bool isMaxOrZero(ScalarEvolution *SE) const;
 
-    /// Return true if any backedge taken count expressions refer to the given
-    /// subexpression.
-    bool hasOperand(const SCEV *S, ScalarEvolution *SE) const;
+    /// Append the backedge taken count expressions this information is made
+    /// of, i.e. the exact count of every exit and the maximum count, to
+    /// \p Exprs.
+    void getExprs(SmallVectorImpl<const SCEV *> &Exprs) const;
 
     /// Invalidate this result and free associated memory.
     void clear();
@@ -1731,8 +1732,25 @@ private:
   /// to be a constant.
   Optional<APInt> computeConstantDifference(const SCEV *LHS, const SCEV *RHS);
 
-  /// Drop memoized information computed for S.
-  void forgetMemoizedResults(const SCEV *S);
+  /// Drop memoized information computed for the expressions in \p SCEVs, and
+  /// the backedge taken counts that contain any of them.
+  void forgetMemoizedResults(ArrayRef<const SCEV *> SCEVs);
+
+  /// Record in \c SCEVUsers that \p User is a user of its operands.
+  void registerUser(const SCEV *User);
+
+  /// Add or remove the entries of \c BECountUsers for the backedge taken
+  /// information \p BTI of loop \p L, which is the predicated information if
+  /// \p Predicated is true.
+  void registerBECountUsers(const Loop *L, const BackedgeTakenInfo &BTI,
+                            bool Predicated);
+  void unregisterBECountUsers(const Loop *L, const BackedgeTakenInfo &BTI,
+                              bool Predicated);
+
+  /// Drop the backedge taken information of \p L from \p Map, and forget
+  /// its entries in \c BECountUsers.
+  void eraseBackedgeTakenInfo(DenseMap<const Loop *, BackedgeTakenInfo> &Map,
+                              const Loop *L);
 
   /// Return an existing SCEV for V if there is one, otherwise return nullptr.
   const SCEV *getExistingSCEV(Value *V);
@@ -1825,6 +1843,10 @@ private:
   bool doesIVOverflowOnGT(const SCEV *RHS, const SCEV *Stride, bool IsSigned,
                           bool NoWrap);
 
+  /// Return the expression of type \p SCEVType with operands \p Ops if it
+  /// has already been created, or null otherwise.
+  SCEV *findExistingSCEVInCache(int SCEVType, ArrayRef<const SCEV *> Ops);
+
   /// Get add expr already created or create a new one.
   const SCEV *getOrCreateAddExpr(SmallVectorImpl<const SCEV *> &Ops,
                                  SCEV::NoWrapFlags Flags);
@@ -1857,6 +1879,17 @@ private:
   /// loop.
   DenseMap<const Loop *, SmallVector<const SCEV *, 4>> LoopUsers;
 
+  /// This maps every expression to the expressions that have it as a direct
+  /// operand. Following it transitively finds every expression that contains
+  /// a given one, without walking the expressions themselves.
+  DenseMap<const SCEV *, SmallPtrSet<const SCEV *, 8>> SCEVUsers;
+
+  /// This maps the expressions of the cached backedge taken counts to the
+  /// loops they are cached for. The integer part is true for entries of
+  /// \c PredicatedBackedgeTakenCounts.
+  DenseMap<const SCEV *, SmallPtrSet<PointerIntPair<const Loop *, 1, bool>, 4>>
+      BECountUsers;
+
   /// Cache tentative mappings from UnknownSCEVs in a Loop, to a SCEV expression
   /// they can be rewritten into under certain predicates.
   DenseMap<std::pair<const SCEVUnknown *, const Loop *>,
@@ -13,6 +13,7 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/ErrorHandling.h"
 
 namespace llvm {
 
@@ -27,16 +28,52 @@ class GISelWorkList {
   SmallVector<MachineInstr*, N> Worklist;
   DenseMap<MachineInstr*, unsigned> WorklistMap;
 
+#ifndef NDEBUG
+  bool Finalized = true;
+#endif
+
 public:
   GISelWorkList() = default;
 
-  bool empty() const { return WorklistMap.empty(); }
+  bool empty() const {
+    assert(Finalized && "GISelWorkList used without finalizing");
+    return WorklistMap.empty();
+  }
+
+  unsigned size() const {
+    assert(Finalized && "GISelWorkList used without finalizing");
+    return WorklistMap.size();
+  }
+
+  /// Add the specified instruction to the worklist without updating the
+  /// lookup map. This is much cheaper than insert() when populating the list
+  /// with every instruction of a function up front, but the caller must not
+  /// add an instruction twice and must call finalize() before using the list.
+  void deferred_insert(MachineInstr *I) {
+    Worklist.push_back(I);
+#ifndef NDEBUG
+    Finalized = false;
+#endif
+  }
 
-  unsigned size() const { return WorklistMap.size(); }
+  /// Build the lookup map for the instructions added with deferred_insert(),
+  /// sizing it once for all of them.
+  void finalize() {
+    assert(WorklistMap.empty() && "Expecting empty worklistmap");
+    if (Worklist.size() > N)
+      WorklistMap.reserve(Worklist.size());
+    for (unsigned i = 0; i < Worklist.size(); ++i)
+      if (!WorklistMap.try_emplace(Worklist[i], i).second)
+        report_fatal_error("Duplicate elements in the list");
+#ifndef NDEBUG
+    Finalized = true;
+#endif
+  }
 
   /// Add - Add the specified instruction to the worklist if it isn't already
   /// in it.
   void insert(MachineInstr *I) {
+    assert(Finalized && "GISelWorkList used without finalizing");
     if (WorklistMap.try_emplace(I, Worklist.size()).second) {
       Worklist.push_back(I);
     }
@@ -44,6 +81,7 @@ public:
 
   /// Remove - remove I from the worklist if it exists.
   void remove(MachineInstr *I) {
+    assert(Finalized && "GISelWorkList used without finalizing");
     auto It = WorklistMap.find(I);
     if (It == WorklistMap.end()) return; // Not in worklist.
 
@@ -54,6 +92,7 @@ public:
   }
 
   MachineInstr *pop_back_val() {
+    assert(Finalized && "GISelWorkList used without finalizing");
     MachineInstr *I;
     do {
       I = Worklist.pop_back_val();
@@ -739,7 +739,9 @@ public:
 
   /// Compute any ancillary tables needed to quickly decide how an operation
   /// should be handled. This must be called after all "set*Action"methods but
-  /// before any query is made or incorrect results may be returned.
+  /// before any query is made or incorrect results may be returned. Once the
+  /// tables are computed, queries only read them, so they may be made from
+  /// several threads at once.
   void computeTables();
 
   /// Perform simple self-diagnostic and assert if there is anything obviously
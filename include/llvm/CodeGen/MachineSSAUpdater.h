@@ -39,6 +39,13 @@ private:
   //typedef DenseMap<MachineBasicBlock*, unsigned > AvailableValsTy;
   void *AV = nullptr;
 
+  /// MiddleVals - The value to use for uses in the middle of a block that
+  /// has an available value, computed once per block by
+  /// GetValueInMiddleOfBlock.  Every use in such a block sees the same
+  /// incoming value, so rewriting many uses does not redo the predecessor
+  /// walk and PHI search for each of them.
+  void *MiddleVals = nullptr;
+
   /// VR - Current virtual register whose uses are being updated.
   unsigned VR;
 
@@ -106,6 +113,7 @@ public:
 
 private:
   unsigned GetValueAtEndOfBlockInternal(MachineBasicBlock *BB);
+  unsigned GetValueInMiddleOfBlockInternal(MachineBasicBlock *BB);
 };
 
 } // end namespace llvm
@@ -396,6 +396,19 @@ class RegPressureTracker {
   /// Live-through pressure.
   std::vector<unsigned> LiveThruPressure;
 
+  /// Pressure set limits, including live-through pressure, beyond which
+  /// pressure is considered excess. Kept in sync with LiveThruPressure so that
+  /// the per-candidate delta queries index one flat vector instead of
+  /// consulting RegisterClassInfo for every pressure set.
+  std::vector<unsigned> ExcessLimits;
+
+  /// Snapshot space for the speculative pressure queries. This persists so
+  /// that querying each scheduling candidate does not allocate.
+  std::vector<unsigned> SavedPressure;
+  std::vector<unsigned> SavedMaxPressure;
+
+  void updateExcessLimits();
+
 public:
   RegPressureTracker(IntervalPressure &rp) : P(rp), RequireIntervals(true) {}
   RegPressureTracker(RegionPressure &rp) : P(rp), RequireIntervals(false) {}
@@ -452,6 +465,7 @@ public:
   /// Copy an existing live thru pressure result.
   void initLiveThru(ArrayRef<unsigned> PressureSet) {
     LiveThruPressure.assign(PressureSet.begin(), PressureSet.end());
+    updateExcessLimits();
   }
 
   ArrayRef<unsigned> getLiveThru() const { return LiveThruPressure; }
@@ -26,6 +26,9 @@
 /* Define if threads enabled */
 #cmakedefine01 LLVM_ENABLE_THREADS
 
+/* Define if the LLVMContext tables for operand-free entities are locked */
+#cmakedefine01 LLVM_ENABLE_THREADSAFE_LEAF_UNIQUING
+
 /* Has gcc/MSVC atomic intrinsics */
 #cmakedefine01 LLVM_HAS_ATOMICS
 
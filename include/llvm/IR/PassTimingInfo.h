@@ -21,11 +21,14 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Timer.h"
 #include <string>
+#include <vector>
 
 namespace llvm {
 
+class Function;
 class Pass;
 class TimerGroup;
+class raw_ostream;
 
 /// Provides a generic interface for collecting pass timing information.
 /// Legacy pass managers should specialize with \p PassInfo*.
@@ -68,6 +71,60 @@ private:
 Timer *getPassTimer(Pass *);
 Timer *getPassTimer(StringRef);
 
+/// Collects a record for every legacy function pass run on every function
+/// when -time-passes-per-function=<file> is given: wall and user time,
+/// instruction counts before and after the pass, and the change in malloc'd
+/// bytes. The records are written to the file as JSON when the report is
+/// destroyed at llvm_shutdown.
+class FunctionPassTimingReport {
+  struct PassRecord {
+    std::string PassID;
+    double WallTime;
+    double UserTime;
+    int64_t MallocBytes;
+    unsigned InstrsBefore;
+    unsigned InstrsAfter;
+    /// Machine instruction counts, only set for MachineFunctionPasses.
+    bool HasMachineInstrs;
+    unsigned MachineInstrsBefore;
+    unsigned MachineInstrsAfter;
+  };
+
+  struct FunctionRecord {
+    std::string Name;
+    std::vector<PassRecord> Passes;
+  };
+
+  StringMap<unsigned> FunctionIndex;
+  std::vector<FunctionRecord> Functions;
+
+  /// State of the pass currently running, between startPass and stopPass.
+  PassRecord Current;
+  TimeRecord StartTime;
+  size_t StartMalloc = 0;
+  bool InPass = false;
+
+public:
+  /// Writes the report to the -time-passes-per-function file.
+  ~FunctionPassTimingReport();
+
+  /// Returns the report if -time-passes-per-function is enabled, creating it
+  /// on first use, and null otherwise.
+  static FunctionPassTimingReport *get();
+
+  /// Starts measuring \p P running on \p F.
+  void startPass(Pass *P, Function &F);
+
+  /// Records machine instruction counts for the pass currently running.
+  void setMachineInstrCounts(unsigned Before, unsigned After);
+
+  /// Finishes measuring the pass currently running on \p F.
+  void stopPass(Function &F);
+
+  /// Prints all records collected so far as JSON.
+  void print(raw_ostream &OS) const;
+};
+
 /// If the user specifies the -time-passes argument on an LLVM tool command line
 /// then the value of this boolean will be true, otherwise false.
 /// This is the storage for the -time-passes option.
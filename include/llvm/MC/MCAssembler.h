@@ -184,9 +184,15 @@ private:
   /// were adjusted.
   bool layoutOnce(MCAsmLayout &Layout);
 
-  /// Perform one layout iteration of the given section and return true
-  /// if any offsets were adjusted.
-  bool layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec);
+  /// Perform one layout iteration of the given section and return the first
+  /// fragment which was relaxed, or null if no offsets were adjusted.
+  ///
+  /// If \p FirstChanged is non-null, the previous iteration relaxed it and no
+  /// fragment before it. Relaxable fragments which cannot observe the offset
+  /// of \p FirstChanged, or of anything after it, were already found not to
+  /// need relaxation and are skipped.
+  MCFragment *layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec,
+                                const MCFragment *FirstChanged);
 
   bool relaxInstruction(MCAsmLayout &Layout, MCRelaxableFragment &IF);
 
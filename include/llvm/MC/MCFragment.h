@@ -55,6 +55,20 @@ private:
 protected:
   bool HasInstructions;
 
+  /// \name Encoded Fragment Data
+  /// @{
+  //
+  // These belong to MCEncodedFragment, but are stored here so they pack into
+  // the padding after Kind and HasInstructions instead of growing every
+  // encoded fragment by another word.
+
+  /// Should this fragment be aligned to the end of a bundle?
+  bool AlignToBundleEnd = false;
+
+  uint8_t BundlePadding = 0;
+
+  /// @}
+
 private:
   /// LayoutOrder - The layout order of this fragment.
   unsigned LayoutOrder;
@@ -126,11 +140,6 @@ public:
 /// data.
 ///
 class MCEncodedFragment : public MCFragment {
-  /// Should this fragment be aligned to the end of a bundle?
-  bool AlignToBundleEnd = false;
-
-  uint8_t BundlePadding = 0;
-
 protected:
   MCEncodedFragment(MCFragment::FragmentType FType, bool HasInstructions,
                     MCSection *Sec)
@@ -52,6 +52,12 @@ protected:
                    std::unique_ptr<MCCodeEmitter> Emitter);
   ~MCObjectStreamer();
 
+  /// Encode \p Inst directly onto the end of \p DF, appending its fixups with
+  /// offsets relative to the fragment. Returns the index of the first fixup
+  /// that was added.
+  size_t encodeInstToDataFragment(MCDataFragment &DF, const MCInst &Inst,
+                                  const MCSubtargetInfo &STI);
+
 public:
   /// state management
   void reset() override;
@@ -33,6 +33,20 @@ class AsmLexer : public MCAsmLexer {
   bool IsParsingMSInlineAsm = false;
   bool IsPeeking = false;
 
+  /// The comment and statement separator strings of MAI, which are checked at
+  /// the start of every token.
+  StringRef CommentString;
+  StringRef SeparatorString;
+
+  /// Characters that may continue an identifier, indexed by unsigned char.
+  /// '@' is handled separately since AllowAtInIdentifier can change.
+  bool IdentifierChars[256];
+
+  bool isIdentifierChar(char C) const {
+    return IdentifierChars[static_cast<unsigned char>(C)] ||
+           (C == '@' && AllowAtInIdentifier);
+  }
+
 protected:
   /// LexToken - Read the next token and return its code.
   AsmToken LexToken() override;
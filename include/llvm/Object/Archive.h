@@ -14,6 +14,7 @@
 #ifndef LLVM_OBJECT_ARCHIVE_H
 #define LLVM_OBJECT_ARCHIVE_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/iterator_range.h"
@@ -22,6 +23,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Threading.h"
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
@@ -257,7 +259,9 @@ public:
     return v->isArchive();
   }
 
-  // check if a symbol is in the archive
+  // check if a symbol is in the archive. The first call builds a hash index
+  // over the symbol table, so later lookups do not scan it. Safe to call
+  // concurrently.
   Expected<Optional<Child>> findSym(StringRef name) const;
 
   bool isEmpty() const;
@@ -281,6 +285,11 @@ private:
   unsigned Format : 3;
   unsigned IsThin : 1;
   mutable std::vector<std::unique_ptr<MemoryBuffer>> ThinBuffers;
+
+  /// Maps each symbol name to its first entry in the symbol table. Built
+  /// lazily by findSym, exactly once even if it is called concurrently.
+  mutable DenseMap<StringRef, Symbol> SymbolIndex;
+  mutable llvm::once_flag SymbolIndexOnce;
 };
 
 } // end namespace object
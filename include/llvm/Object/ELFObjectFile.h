@@ -215,6 +215,7 @@ public:
 
   using Elf_Sym = typename ELFT::Sym;
   using Elf_Shdr = typename ELFT::Shdr;
+  using Elf_Shdr_Range = typename ELFT::ShdrRange;
   using Elf_Ehdr = typename ELFT::Ehdr;
   using Elf_Rel = typename ELFT::Rel;
   using Elf_Rela = typename ELFT::Rela;
@@ -222,16 +223,34 @@ public:
 
 private:
   ELFObjectFile(MemoryBufferRef Object, ELFFile<ELFT> EF,
-                const Elf_Shdr *DotDynSymSec, const Elf_Shdr *DotSymtabSec,
-                ArrayRef<Elf_Word> ShndxTable);
+                Elf_Shdr_Range Sections, const Elf_Shdr *DotDynSymSec,
+                const Elf_Shdr *DotSymtabSec, ArrayRef<Elf_Word> ShndxTable,
+                StringRef DotShstrtab, StringRef DotDynStrtab,
+                StringRef DotStrtab);
+
+  /// Look up section \p Index in the section header table validated by
+  /// create(), rather than revalidating the ELF header on every access.
+  Expected<const Elf_Shdr *> getSectionByIndex(uint32_t Index) const {
+    return object::getSection<ELFT>(Sections, Index);
+  }
+
+  Expected<StringRef> getStringTableForSymtab(const Elf_Shdr *SymTab) const;
 
 protected:
   ELFFile<ELFT> EF;
 
+  Elf_Shdr_Range Sections;                // Validated section header table.
   const Elf_Shdr *DotDynSymSec = nullptr; // Dynamic symbol table section.
   const Elf_Shdr *DotSymtabSec = nullptr; // Symbol table section.
   ArrayRef<Elf_Word> ShndxTable;
 
+  // String tables resolved by create(). A table that failed validation is
+  // left empty and looked up again on use, so that the error is reported by
+  // the accessor that needs it.
+  StringRef DotShstrtab;  // Section name string table.
+  StringRef DotDynStrtab; // String table of DotDynSymSec.
+  StringRef DotStrtab;    // String table of DotSymtabSec.
+
   void moveSymbolNext(DataRefImpl &Symb) const override;
   Expected<StringRef> getSymbolName(DataRefImpl Symb) const override;
   Expected<uint64_t> getSymbolAddress(DataRefImpl Symb) const override;
@@ -279,7 +298,7 @@ protected:
 
   /// Get the relocation section that contains \a Rel.
   const Elf_Shdr *getRelSection(DataRefImpl Rel) const {
-    auto RelSecOrErr = EF.getSection(Rel.d.a);
+    auto RelSecOrErr = getSectionByIndex(Rel.d.a);
     if (!RelSecOrErr)
       report_fatal_error(errorToErrorCode(RelSecOrErr.takeError()).message());
     return *RelSecOrErr;
@@ -295,13 +314,7 @@ protected:
     assert(SymTable->sh_type == ELF::SHT_SYMTAB ||
            SymTable->sh_type == ELF::SHT_DYNSYM);
 
-    auto SectionsOrErr = EF.sections();
-    if (!SectionsOrErr) {
-      DRI.d.a = 0;
-      DRI.d.b = 0;
-      return DRI;
-    }
-    uintptr_t SHT = reinterpret_cast<uintptr_t>((*SectionsOrErr).begin());
+    uintptr_t SHT = reinterpret_cast<uintptr_t>(Sections.begin());
     unsigned SymTableIndex =
         (reinterpret_cast<uintptr_t>(SymTable) - SHT) / sizeof(Elf_Shdr);
 
@@ -351,7 +364,10 @@ public:
   const Elf_Rela *getRela(DataRefImpl Rela) const;
 
   const Elf_Sym *getSymbol(DataRefImpl Sym) const {
-    auto Ret = EF.template getEntry<Elf_Sym>(Sym.d.a, Sym.d.b);
+    auto SecOrErr = getSectionByIndex(Sym.d.a);
+    if (!SecOrErr)
+      report_fatal_error(errorToErrorCode(SecOrErr.takeError()).message());
+    auto Ret = EF.template getEntry<Elf_Sym>(*SecOrErr, Sym.d.b);
     if (!Ret)
       report_fatal_error(errorToErrorCode(Ret.takeError()).message());
     return *Ret;
@@ -380,11 +396,7 @@ public:
   unsigned getPlatformFlags() const override { return EF.getHeader()->e_flags; }
 
   std::error_code getBuildAttributes(ARMAttributeParser &Attributes) const override {
-    auto SectionsOrErr = EF.sections();
-    if (!SectionsOrErr)
-      return errorToErrorCode(SectionsOrErr.takeError());
-
-    for (const Elf_Shdr &Sec : *SectionsOrErr) {
+    for (const Elf_Shdr &Sec : Sections) {
       if (Sec.sh_type == ELF::SHT_ARM_ATTRIBUTES) {
         auto ErrorOrContents = EF.getSectionContents(&Sec);
         if (!ErrorOrContents)
@@ -427,20 +439,28 @@ void ELFObjectFile<ELFT>::moveSymbolNext(DataRefImpl &Sym) const {
 template <class ELFT>
 Expected<StringRef> ELFObjectFile<ELFT>::getSymbolName(DataRefImpl Sym) const {
   const Elf_Sym *ESym = getSymbol(Sym);
-  auto SymTabOrErr = EF.getSection(Sym.d.a);
+  auto SymTabOrErr = getSectionByIndex(Sym.d.a);
   if (!SymTabOrErr)
     return SymTabOrErr.takeError();
-  const Elf_Shdr *SymTableSec = *SymTabOrErr;
-  auto StrTabOrErr = EF.getSection(SymTableSec->sh_link);
-  if (!StrTabOrErr)
-    return StrTabOrErr.takeError();
-  const Elf_Shdr *StringTableSec = *StrTabOrErr;
-  auto SymStrTabOrErr = EF.getStringTable(StringTableSec);
+  auto SymStrTabOrErr = getStringTableForSymtab(*SymTabOrErr);
   if (!SymStrTabOrErr)
     return SymStrTabOrErr.takeError();
   return ESym->getName(*SymStrTabOrErr);
 }
 
+template <class ELFT>
+Expected<StringRef>
+ELFObjectFile<ELFT>::getStringTableForSymtab(const Elf_Shdr *SymTab) const {
+  if (SymTab == DotSymtabSec && !DotStrtab.empty())
+    return DotStrtab;
+  if (SymTab == DotDynSymSec && !DotDynStrtab.empty())
+    return DotDynStrtab;
+  auto StrTabOrErr = getSectionByIndex(SymTab->sh_link);
+  if (!StrTabOrErr)
+    return StrTabOrErr.takeError();
+  return EF.getStringTable(*StrTabOrErr);
+}
+
 template <class ELFT>
 uint64_t ELFObjectFile<ELFT>::getSectionFlags(DataRefImpl Sec) const {
   return getSection(Sec)->sh_flags;
@@ -485,7 +505,7 @@ ELFObjectFile<ELFT>::getSymbolAddress(DataRefImpl Symb) const {
   }
 
   const Elf_Ehdr *Header = EF.getHeader();
-  auto SymTabOrErr = EF.getSection(Symb.d.a);
+  auto SymTabOrErr = getSectionByIndex(Symb.d.a);
   if (!SymTabOrErr)
     return SymTabOrErr.takeError();
   const Elf_Shdr *SymTab = *SymTabOrErr;
@@ -637,7 +657,7 @@ template <class ELFT>
 Expected<section_iterator>
 ELFObjectFile<ELFT>::getSymbolSection(DataRefImpl Symb) const {
   const Elf_Sym *Sym = getSymbol(Symb);
-  auto SymTabOrErr = EF.getSection(Symb.d.a);
+  auto SymTabOrErr = getSectionByIndex(Symb.d.a);
   if (!SymTabOrErr)
     return SymTabOrErr.takeError();
   const Elf_Shdr *SymTab = *SymTabOrErr;
@@ -653,7 +673,9 @@ void ELFObjectFile<ELFT>::moveSectionNext(DataRefImpl &Sec) const {
 template <class ELFT>
 std::error_code ELFObjectFile<ELFT>::getSectionName(DataRefImpl Sec,
                                                     StringRef &Result) const {
-  auto Name = EF.getSectionName(&*getSection(Sec));
+  auto Name = DotShstrtab.empty()
+                  ? EF.getSectionName(getSection(Sec))
+                  : EF.getSectionName(getSection(Sec), DotShstrtab);
   if (!Name)
     return errorToErrorCode(Name.takeError());
   Result = *Name;
@@ -667,13 +689,7 @@ uint64_t ELFObjectFile<ELFT>::getSectionAddress(DataRefImpl Sec) const {
 
 template <class ELFT>
 uint64_t ELFObjectFile<ELFT>::getSectionIndex(DataRefImpl Sec) const {
-  auto SectionsOrErr = EF.sections();
-  handleAllErrors(std::move(SectionsOrErr.takeError()),
-                  [](const ErrorInfoBase &) {
-                    llvm_unreachable("unable to get section index");
-                  });
-  const Elf_Shdr *First = SectionsOrErr->begin();
-  return getSection(Sec) - First;
+  return getSection(Sec) - Sections.begin();
 }
 
 template <class ELFT>
@@ -730,11 +746,7 @@ ELFObjectFile<ELFT>::dynamic_relocation_sections() const {
   std::vector<SectionRef> Res;
   std::vector<uintptr_t> Offsets;
 
-  auto SectionsOrErr = EF.sections();
-  if (!SectionsOrErr)
-    return Res;
-
-  for (const Elf_Shdr &Sec : *SectionsOrErr) {
+  for (const Elf_Shdr &Sec : Sections) {
     if (Sec.sh_type != ELF::SHT_DYNAMIC)
       continue;
     Elf_Dyn *Dynamic =
@@ -746,7 +758,7 @@ ELFObjectFile<ELFT>::dynamic_relocation_sections() const {
       }
     }
   }
-  for (const Elf_Shdr &Sec : *SectionsOrErr) {
+  for (const Elf_Shdr &Sec : Sections) {
     if (is_contained(Offsets, Sec.sh_offset))
       Res.emplace_back(toDRI(&Sec), this);
   }
@@ -762,10 +774,7 @@ template <class ELFT>
 relocation_iterator
 ELFObjectFile<ELFT>::section_rel_begin(DataRefImpl Sec) const {
   DataRefImpl RelData;
-  auto SectionsOrErr = EF.sections();
-  if (!SectionsOrErr)
-    return relocation_iterator(RelocationRef());
-  uintptr_t SHT = reinterpret_cast<uintptr_t>((*SectionsOrErr).begin());
+  uintptr_t SHT = reinterpret_cast<uintptr_t>(Sections.begin());
   RelData.d.a = (Sec.p - SHT) / EF.getHeader()->e_shentsize;
   RelData.d.b = 0;
   return relocation_iterator(RelocationRef(RelData, this));
@@ -782,7 +791,7 @@ ELFObjectFile<ELFT>::section_rel_end(DataRefImpl Sec) const {
   const Elf_Shdr *RelSec = getRelSection(RelData);
 
   // Error check sh_link here so that getRelocationSymbol can just use it.
-  auto SymSecOrErr = EF.getSection(RelSec->sh_link);
+  auto SymSecOrErr = getSectionByIndex(RelSec->sh_link);
   if (!SymSecOrErr)
     report_fatal_error(errorToErrorCode(SymSecOrErr.takeError()).message());
 
@@ -801,7 +810,7 @@ ELFObjectFile<ELFT>::getRelocatedSection(DataRefImpl Sec) const {
   if (Type != ELF::SHT_REL && Type != ELF::SHT_RELA)
     return section_end();
 
-  auto R = EF.getSection(EShdr->sh_info);
+  auto R = getSectionByIndex(EShdr->sh_info);
   if (!R)
     report_fatal_error(errorToErrorCode(R.takeError()).message());
   return section_iterator(SectionRef(toDRI(*R), this));
@@ -873,8 +882,9 @@ ELFObjectFile<ELFT>::getRelocationAddend(DataRefImpl Rel) const {
 template <class ELFT>
 const typename ELFObjectFile<ELFT>::Elf_Rel *
 ELFObjectFile<ELFT>::getRel(DataRefImpl Rel) const {
-  assert(getRelSection(Rel)->sh_type == ELF::SHT_REL);
-  auto Ret = EF.template getEntry<Elf_Rel>(Rel.d.a, Rel.d.b);
+  const Elf_Shdr *RelSec = getRelSection(Rel);
+  assert(RelSec->sh_type == ELF::SHT_REL);
+  auto Ret = EF.template getEntry<Elf_Rel>(RelSec, Rel.d.b);
   if (!Ret)
     report_fatal_error(errorToErrorCode(Ret.takeError()).message());
   return *Ret;
@@ -883,8 +893,9 @@ ELFObjectFile<ELFT>::getRel(DataRefImpl Rel) const {
 template <class ELFT>
 const typename ELFObjectFile<ELFT>::Elf_Rela *
 ELFObjectFile<ELFT>::getRela(DataRefImpl Rela) const {
-  assert(getRelSection(Rela)->sh_type == ELF::SHT_RELA);
-  auto Ret = EF.template getEntry<Elf_Rela>(Rela.d.a, Rela.d.b);
+  const Elf_Shdr *RelSec = getRelSection(Rela);
+  assert(RelSec->sh_type == ELF::SHT_RELA);
+  auto Ret = EF.template getEntry<Elf_Rela>(RelSec, Rela.d.b);
   if (!Ret)
     report_fatal_error(errorToErrorCode(Ret.takeError()).message());
   return *Ret;
@@ -928,25 +939,50 @@ ELFObjectFile<ELFT>::create(MemoryBufferRef Object) {
     }
     }
   }
-  return ELFObjectFile<ELFT>(Object, EF, DotDynSymSec, DotSymtabSec,
-                             ShndxTable);
+
+  // Resolve the string tables up front. Errors are dropped here and
+  // reported by the accessors, which look the tables up again when the
+  // cached copy is missing.
+  auto GetStrtab = [&](Expected<StringRef> TableOrErr) {
+    if (TableOrErr)
+      return *TableOrErr;
+    consumeError(TableOrErr.takeError());
+    return StringRef();
+  };
+  auto GetSymtabStrtab = [&](const Elf_Shdr *SymTab) {
+    if (!SymTab)
+      return StringRef();
+    return GetStrtab(EF.getStringTableForSymtab(*SymTab, *SectionsOrErr));
+  };
+  StringRef DotShstrtab =
+      GetStrtab(EF.getSectionStringTable(*SectionsOrErr));
+  StringRef DotDynStrtab = GetSymtabStrtab(DotDynSymSec);
+  StringRef DotStrtab = GetSymtabStrtab(DotSymtabSec);
+
+  return ELFObjectFile<ELFT>(Object, EF, *SectionsOrErr, DotDynSymSec,
+                             DotSymtabSec, ShndxTable, DotShstrtab,
+                             DotDynStrtab, DotStrtab);
 }
 
 template <class ELFT>
-ELFObjectFile<ELFT>::ELFObjectFile(MemoryBufferRef Object, ELFFile<ELFT> EF,
-                                   const Elf_Shdr *DotDynSymSec,
-                                   const Elf_Shdr *DotSymtabSec,
-                                   ArrayRef<Elf_Word> ShndxTable)
+ELFObjectFile<ELFT>::ELFObjectFile(
+    MemoryBufferRef Object, ELFFile<ELFT> EF, Elf_Shdr_Range Sections,
+    const Elf_Shdr *DotDynSymSec, const Elf_Shdr *DotSymtabSec,
+    ArrayRef<Elf_Word> ShndxTable, StringRef DotShstrtab,
+    StringRef DotDynStrtab, StringRef DotStrtab)
     : ELFObjectFileBase(
           getELFType(ELFT::TargetEndianness == support::little, ELFT::Is64Bits),
           Object),
-      EF(EF), DotDynSymSec(DotDynSymSec), DotSymtabSec(DotSymtabSec),
-      ShndxTable(ShndxTable) {}
+      EF(EF), Sections(Sections), DotDynSymSec(DotDynSymSec),
+      DotSymtabSec(DotSymtabSec), ShndxTable(ShndxTable),
+      DotShstrtab(DotShstrtab), DotDynStrtab(DotDynStrtab),
+      DotStrtab(DotStrtab) {}
 
 template <class ELFT>
 ELFObjectFile<ELFT>::ELFObjectFile(ELFObjectFile<ELFT> &&Other)
-    : ELFObjectFile(Other.Data, Other.EF, Other.DotDynSymSec,
-                    Other.DotSymtabSec, Other.ShndxTable) {}
+    : ELFObjectFile(Other.Data, Other.EF, Other.Sections, Other.DotDynSymSec,
+                    Other.DotSymtabSec, Other.ShndxTable, Other.DotShstrtab,
+                    Other.DotDynStrtab, Other.DotStrtab) {}
 
 template <class ELFT>
 basic_symbol_iterator ELFObjectFile<ELFT>::symbol_begin() const {
@@ -980,18 +1016,12 @@ elf_symbol_iterator ELFObjectFile<ELFT>::dynamic_symbol_end() const {
 
 template <class ELFT>
 section_iterator ELFObjectFile<ELFT>::section_begin() const {
-  auto SectionsOrErr = EF.sections();
-  if (!SectionsOrErr)
-    return section_iterator(SectionRef());
-  return section_iterator(SectionRef(toDRI((*SectionsOrErr).begin()), this));
+  return section_iterator(SectionRef(toDRI(Sections.begin()), this));
 }
 
 template <class ELFT>
 section_iterator ELFObjectFile<ELFT>::section_end() const {
-  auto SectionsOrErr = EF.sections();
-  if (!SectionsOrErr)
-    return section_iterator(SectionRef());
-  return section_iterator(SectionRef(toDRI((*SectionsOrErr).end()), this));
+  return section_iterator(SectionRef(toDRI(Sections.end()), this));
 }
 
 template <class ELFT>
@@ -16,6 +16,7 @@
 #ifndef LLVM_TRANSFORMS_IPO_FUNCTIONATTRS_H
 #define LLVM_TRANSFORMS_IPO_FUNCTIONATTRS_H
 
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Analysis/CGSCCPassManager.h"
 #include "llvm/Analysis/LazyCallGraph.h"
 #include "llvm/IR/PassManager.h"
@@ -23,7 +24,9 @@
 namespace llvm {
 
 class AAResults;
+class Argument;
 class Function;
+class Instruction;
 class Module;
 class Pass;
 
@@ -39,6 +42,69 @@ enum MemoryAccessKind {
 /// Returns the memory access properties of this copy of the function.
 MemoryAccessKind computeFunctionBodyMemoryAccess(Function &F, AAResults &AAR);
 
+/// The effects of a function body that the inference of readnone/readonly,
+/// nocapture, nounwind and norecurse depends on, computed from the body alone.
+///
+/// Calls are recorded rather than resolved against the attributes of their
+/// callees, so a summary stays valid while attributes are inferred for other
+/// functions. It only has to be recomputed when the body itself changes.
+struct FunctionEffectSummary {
+  /// A call or invoke in the body.
+  struct CallEffect {
+    Instruction *Call;
+    /// True if every pointer argument of the call points to local or constant
+    /// memory, so an argmemonly callee does not access non-local memory.
+    bool OnlyLocalArguments;
+  };
+
+  /// An argument of a direct callee, identified by its number so that
+  /// recording it does not create the callee's arguments if they are still
+  /// lazy.
+  struct CalleeArgument {
+    Function *Callee;
+    unsigned ArgNo;
+  };
+
+  /// A pointer argument that the body does not capture other than by passing
+  /// it to the arguments in \c PassedTo of direct callees.
+  struct ArgumentEffect {
+    Argument *Arg;
+    SmallVector<CalleeArgument, 2> PassedTo;
+  };
+
+  /// True if instructions other than calls read or write non-local memory.
+  bool ReadsMemory = false;
+  bool WritesMemory = false;
+
+  /// True if an instruction other than a call may throw.
+  bool MayThrow = false;
+
+  /// True if the body contains a call whose callee is not known.
+  bool HasIndirectCall = false;
+
+  SmallVector<CallEffect, 8> Calls;
+  SmallVector<ArgumentEffect, 4> UncapturedArgs;
+};
+
+/// Compute the effect summary of the body of \p F. This does not modify the IR
+/// and only touches the arguments of \p F itself, which may be created
+/// lazily, and not those of its callees. Summaries of different functions may
+/// therefore be computed concurrently.
+FunctionEffectSummary computeFunctionEffectSummary(Function &F);
+
+/// Analysis pass providing the effect summary of a function body, so it can be
+/// reused by attribute inference until the body is modified.
+class FunctionEffectsAnalysis
+    : public AnalysisInfoMixin<FunctionEffectsAnalysis> {
+  friend AnalysisInfoMixin<FunctionEffectsAnalysis>;
+  static AnalysisKey Key;
+
+public:
+  using Result = FunctionEffectSummary;
+
+  Result run(Function &F, FunctionAnalysisManager &AM);
+};
+
 /// Computes function attributes in post-order over the call graph.
 ///
 /// By operating in post-order, this pass computes precise attributes for
@@ -57,6 +123,20 @@ struct PostOrderFunctionAttrsPass : PassInfoMixin<PostOrderFunctionAttrsPass> {
 /// in post-order.
 Pass *createPostOrderFunctionAttrsLegacyPass();
 
+/// Computes readnone/readonly/writeonly, nocapture, nounwind and norecurse for
+/// a whole module from function effect summaries.
+///
+/// The summaries of all the functions are computed up front, in parallel, and
+/// then propagated bottom-up over the SCCs of the call graph without looking
+/// at the function bodies again. Summaries already cached by the function
+/// analysis manager are reused.
+struct SummaryFunctionAttrsPass : PassInfoMixin<SummaryFunctionAttrsPass> {
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
+};
+
+/// Create a legacy pass manager instance of the summary based module pass.
+Pass *createSummaryFunctionAttrsLegacyPass();
+
 /// A pass to do RPO deduction and propagation of function attributes.
 ///
 /// This pass provides a general RPO or "top down" propagation of
@@ -10,12 +10,14 @@
 #ifndef LLVM_TRANSFORMS_IPO_INLINER_H
 #define LLVM_TRANSFORMS_IPO_INLINER_H
 
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/Analysis/CGSCCPassManager.h"
 #include "llvm/Analysis/CallGraphSCCPass.h"
 #include "llvm/Analysis/InlineCost.h"
 #include "llvm/Analysis/LazyCallGraph.h"
 #include "llvm/IR/CallSite.h"
 #include "llvm/IR/PassManager.h"
+#include "llvm/IR/ValueMap.h"
 #include "llvm/Transforms/Utils/ImportedFunctionsInliningStatistics.h"
 #include <utility>
 
@@ -68,10 +70,24 @@ struct LegacyInlinerBase : public CallGraphSCCPass {
   /// this function unconditionally.
   bool inlineCalls(CallGraphSCC &SCC);
 
+  /// Return the inline cost summaries to use for the callee of \p CS, or null
+  /// if they are disabled or the callee may still change in this SCC.
+  InlineCostSummaries *getCostSummaries(CallSite CS);
+
 private:
   // Insert @llvm.lifetime intrinsics.
   bool InsertLifetime = true;
 
+  // The inline cost summaries of the callees seen so far. The SCCs are visited
+  // bottom-up, so the callees in other SCCs are done being modified. Replacing
+  // a function does not change its body, so the summaries stay with it.
+  struct CostSummariesConfig : ValueMapConfig<const Function *> {
+    enum { FollowRAUW = false };
+  };
+  ValueMap<const Function *, InlineCostSummaries, CostSummariesConfig>
+      CostSummaries;
+  SmallPtrSet<const Function *, 8> CurrentSCCFunctions;
+
 protected:
   AssumptionCacheTracker *ACT;
   ProfileSummaryInfo *PSI;
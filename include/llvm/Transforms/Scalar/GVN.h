@@ -46,6 +46,8 @@ class FunctionPass;
 class IntrinsicInst;
 class LoadInst;
 class LoopInfo;
+class MemorySSA;
+class MemorySSAUpdater;
 class OptimizationRemarkEmitter;
 class PHINode;
 class TargetLibraryInfo;
@@ -160,6 +162,18 @@ private:
   OptimizationRemarkEmitter *ORE;
   ImplicitControlFlowTracking *ICF;
 
+  /// MemorySSA for the current iteration with -enable-gvn-memoryssa. It is
+  /// dropped when GVN changes the CFG, and loads fall back to MD until the
+  /// next iteration rebuilds it.
+  MemorySSA *MSSA = nullptr;
+  MemorySSAUpdater *MSSAU = nullptr;
+
+  /// Loads kept so far in this iteration, keyed on their clobbering memory
+  /// access and pointer operand. A later load with the same key that is
+  /// dominated by one of these reads the same value.
+  DenseMap<std::pair<Value *, Value *>, SmallVector<WeakVH, 2>>
+      LoadsByClobber;
+
   ValueTable VN;
 
   /// A mapping from value numbers to lists of Value*'s that
@@ -242,6 +256,7 @@ private:
   // Helper functions of redundant load elimination
   bool processLoad(LoadInst *L);
   bool processNonLocalLoad(LoadInst *L);
+  MemDepResult getMemorySSADependency(LoadInst *L);
   bool processAssumeIntrinsic(IntrinsicInst *II);
 
   /// Given a local dependency (Def or Clobber) determine if a value is
@@ -93,6 +93,10 @@ public:
 /// side of claiming that two functions are different).
 class FunctionComparator {
 public:
+  /// If GN is null, references to globals are compared by identity. That is
+  /// enough to tell whether two functions are equal, but the order it gives to
+  /// unequal ones is not deterministic. Unlike a GlobalNumberState, it does not
+  /// create value handles, so functions can be compared on several threads.
   FunctionComparator(const Function *F1, const Function *F2,
                      GlobalNumberState* GN)
       : FnL(F1), FnR(F2), GlobalNumbers(GN) {}
@@ -105,6 +109,14 @@ public:
   using FunctionHash = uint64_t;
   static FunctionHash functionHash(Function &);
 
+  /// Hash a function, including the types, constants, referenced globals and
+  /// operand structure of its instructions as compare() sees them. Equivalent
+  /// functions will have the same fingerprint; functions that only differ in a
+  /// constant or a callee, which functionHash maps to the same value, will
+  /// usually not. The IR is only read, so the fingerprints of different
+  /// functions can be computed concurrently.
+  static FunctionHash functionFingerprint(Function &);
+
 protected:
   /// Start the comparison.
   void beginCompare() {
@@ -43,6 +43,8 @@ using namespace llvm;
 #define DEBUG_TYPE "inline-cost"
 
 STATISTIC(NumCallsAnalyzed, "Number of call sites analyzed");
+STATISTIC(NumCallsSummarized,
+          "Number of call sites analyzed from a summary of the callee");
 
 static cl::opt<int> InlineThreshold(
     "inline-threshold", cl::Hidden, cl::init(225), cl::ZeroOrMore,
@@ -125,6 +127,10 @@ class CallAnalyzer : public InstVisitor<CallAnalyzer, bool> {
   /// Tunable parameters that control the analysis.
   const InlineParams &Params;
 
+  /// The summaries of the walks of the callee body to reuse and extend, if
+  /// any.
+  InlineCostSummaries *Summaries;
+
   int Threshold;
   int Cost;
   bool ComputeFullInlineCost;
@@ -146,6 +152,19 @@ class CallAnalyzer : public InstVisitor<CallAnalyzer, bool> {
   // Bonus to be applied when the callee has only one reachable basic block.
   int SingleBBBonus;
 
+  /// True while the walk of the callee body has only seen blocks with a single
+  /// successor.
+  bool SingleBB;
+
+  /// The summary the current walk of the callee body is recorded in, if any,
+  /// and the cost when the walk started.
+  InlineCostSummaries::Summary *Recording;
+  int WalkStartCost;
+
+  /// True if the walk looked at the body of a function other than the callee,
+  /// so its summary is not only determined by the callee body.
+  bool AnalyzedOtherFunction;
+
   /// While we walk the potentially-inlined instructions, we build up and
   /// maintain a mapping of simplified values specific to this callsite. The
   /// idea is to propagate any special information we have about arguments to
@@ -199,6 +218,15 @@ class CallAnalyzer : public InstVisitor<CallAnalyzer, bool> {
   bool simplifyInstruction(Instruction &I, Callable Evaluate);
   ConstantInt *stripAndComputeInBoundsConstantOffsets(Value *&V);
 
+  /// Record that the walk of the callee body would stop here if \p CheckedCost
+  /// reached the threshold, unless it computes the full cost.
+  void noteCostCheck(int64_t CheckedCost);
+
+  /// Emit the remark for a walk of the callee body that stopped because of
+  /// \p IR.
+  void emitFailureRemark(InlineCostSummaries::FailureKind Kind,
+                         InlineResult IR);
+
   /// Return true if the given argument to the function being considered for
   /// inlining has the given attribute set either at the call site or the
   /// function declaration.  Primarily used to inspect call site specific
@@ -229,6 +257,10 @@ class CallAnalyzer : public InstVisitor<CallAnalyzer, bool> {
   // Custom analysis routines.
   InlineResult analyzeBlock(BasicBlock *BB,
                             SmallPtrSetImpl<const Value *> &EphValues);
+  InlineResult analyzeBody(CallSite CS);
+  InlineResult analyzeBodyWithSummaries(CallSite CS);
+  InlineCostSummaries::Key getSummaryKey(CallSite CS);
+  int getMaxThreshold();
 
   // Disable several entry points to the visitor so we don't accidentally use
   // them by declaring but not defining them here.
@@ -274,18 +306,22 @@ public:
                std::function<AssumptionCache &(Function &)> &GetAssumptionCache,
                Optional<function_ref<BlockFrequencyInfo &(Function &)>> &GetBFI,
                ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE,
-               Function &Callee, CallSite CSArg, const InlineParams &Params)
+               Function &Callee, CallSite CSArg, const InlineParams &Params,
+               InlineCostSummaries *Summaries = nullptr)
       : TTI(TTI), GetAssumptionCache(GetAssumptionCache), GetBFI(GetBFI),
         PSI(PSI), F(Callee), DL(F.getParent()->getDataLayout()), ORE(ORE),
-        CandidateCS(CSArg), Params(Params), Threshold(Params.DefaultThreshold),
-        Cost(0), ComputeFullInlineCost(OptComputeFullInlineCost ||
-                                       Params.ComputeFullInlineCost || ORE),
+        CandidateCS(CSArg), Params(Params), Summaries(Summaries),
+        Threshold(Params.DefaultThreshold), Cost(0),
+        ComputeFullInlineCost(OptComputeFullInlineCost ||
+                              Params.ComputeFullInlineCost || ORE),
         IsCallerRecursive(false), IsRecursiveCall(false),
         ExposesReturnsTwice(false), HasDynamicAlloca(false),
         ContainsNoDuplicateCall(false), HasReturn(false), HasIndirectBr(false),
         HasUninlineableIntrinsic(false), UsesVarArgs(false), AllocatedSize(0),
         NumInstructions(0), NumVectorInstructions(0), VectorBonus(0),
-        SingleBBBonus(0), EnableLoadElimination(true), LoadEliminationCost(0),
+        SingleBBBonus(0), SingleBB(true), Recording(nullptr), WalkStartCost(0),
+        AnalyzedOtherFunction(false), EnableLoadElimination(true),
+        LoadEliminationCost(0),
         NumConstantArgs(0), NumConstantOffsetPtrArgs(0), NumAllocaArgs(0),
         NumConstantPtrCmps(0), NumConstantPtrDiffs(0),
         NumInstructionsSimplified(0), SROACostSavings(0),
@@ -1292,6 +1328,7 @@ bool CallAnalyzer::visitCallSite(CallSite CS) {
   // out. Pretend to inline the function, with a custom threshold.
   auto IndirectCallParams = Params;
   IndirectCallParams.DefaultThreshold = InlineConstants::IndirectCallThreshold;
+  AnalyzedOtherFunction = true;
   CallAnalyzer CA(TTI, GetAssumptionCache, GetBFI, PSI, ORE, *F, CS,
                   IndirectCallParams);
   if (CA.analyzeCall(CS)) {
@@ -1435,6 +1472,7 @@ bool CallAnalyzer::visitSwitchInst(SwitchInst &SI) {
       std::min((int64_t)CostUpperBound,
                (int64_t)SI.getNumCases() * InlineConstants::InstrCost + Cost);
 
+  noteCostCheck(CostLowerBound - 1);
   if (CostLowerBound > Threshold && !ComputeFullInlineCost) {
     Cost = CostLowerBound;
     return false;
@@ -1574,7 +1612,6 @@ CallAnalyzer::analyzeBlock(BasicBlock *BB,
     else
       Cost += InlineConstants::InstrCost;
 
-    using namespace ore;
     // If the visit this instruction detected an uninlinable pattern, abort.
     InlineResult IR;
     if (IsRecursiveCall)
@@ -1590,14 +1627,10 @@ CallAnalyzer::analyzeBlock(BasicBlock *BB,
     else if (UsesVarArgs)
       IR = "varargs";
     if (!IR) {
-      if (ORE)
-        ORE->emit([&]() {
-          return OptimizationRemarkMissed(DEBUG_TYPE, "NeverInline",
-                                          CandidateCS.getInstruction())
-                 << NV("Callee", &F) << " has uninlinable pattern ("
-                 << NV("InlineResult", IR.message)
-                 << ") and cost is not fully computed";
-        });
+      if (Recording)
+        Recording->Failure = InlineCostSummaries::UninlinablePattern;
+      else
+        emitFailureRemark(InlineCostSummaries::UninlinablePattern, IR);
       return IR;
     }
 
@@ -1607,18 +1640,16 @@ CallAnalyzer::analyzeBlock(BasicBlock *BB,
     if (IsCallerRecursive &&
         AllocatedSize > InlineConstants::TotalAllocaSizeRecursiveCaller) {
       InlineResult IR = "recursive and allocates too much stack space";
-      if (ORE)
-        ORE->emit([&]() {
-          return OptimizationRemarkMissed(DEBUG_TYPE, "NeverInline",
-                                          CandidateCS.getInstruction())
-                 << NV("Callee", &F) << " is " << NV("InlineResult", IR.message)
-                 << ". Cost is not fully computed";
-        });
+      if (Recording)
+        Recording->Failure = InlineCostSummaries::RecursiveStackSize;
+      else
+        emitFailureRemark(InlineCostSummaries::RecursiveStackSize, IR);
       return IR;
     }
 
     // Check if we've past the maximum possible threshold so we don't spin in
     // huge basic blocks that will never inline.
+    noteCostCheck(Cost);
     if (Cost >= Threshold && !ComputeFullInlineCost)
       return false;
   }
@@ -1703,66 +1734,13 @@ void CallAnalyzer::findDeadBlocks(BasicBlock *CurrBB, BasicBlock *NextBB) {
   }
 }
 
-/// Analyze a call site for potential inlining.
+/// Walk the body of the callee for the call site \p CS, adding up the cost of
+/// the instructions that remain after inlining.
 ///
-/// Returns true if inlining this call is viable, and false if it is not
-/// viable. It computes the cost and adjusts the threshold based on numerous
-/// factors and heuristics. If this method returns false but the computed cost
-/// is below the computed threshold, then inlining was forcibly disabled by
-/// some artifact of the routine.
-InlineResult CallAnalyzer::analyzeCall(CallSite CS) {
-  ++NumCallsAnalyzed;
-
-  // Perform some tweaks to the cost and threshold based on the direct
-  // callsite information.
-
-  // We want to more aggressively inline vector-dense kernels, so up the
-  // threshold, and we'll lower it if the % of vector instructions gets too
-  // low. Note that these bonuses are some what arbitrary and evolved over time
-  // by accident as much as because they are principled bonuses.
-  //
-  // FIXME: It would be nice to remove all such bonuses. At least it would be
-  // nice to base the bonus values on something more scientific.
-  assert(NumInstructions == 0);
-  assert(NumVectorInstructions == 0);
-
-  // Update the threshold based on callsite properties
-  updateThreshold(CS, F);
-
-  // Speculatively apply all possible bonuses to Threshold. If cost exceeds
-  // this Threshold any time, and cost cannot decrease, we can stop processing
-  // the rest of the function body.
-  Threshold += (SingleBBBonus + VectorBonus);
-
-  // Give out bonuses for the callsite, as the instructions setting them up
-  // will be gone after inlining.
-  Cost -= getCallsiteCost(CS, DL);
-
-  // If this function uses the coldcc calling convention, prefer not to inline
-  // it.
-  if (F.getCallingConv() == CallingConv::Cold)
-    Cost += InlineConstants::ColdccPenalty;
-
-  // Check if we're done. This can happen due to bonuses and penalties.
-  if (Cost >= Threshold && !ComputeFullInlineCost)
-    return "high cost";
-
-  if (F.empty())
-    return true;
-
-  Function *Caller = CS.getInstruction()->getFunction();
-  // Check if the caller function is recursive itself.
-  for (User *U : Caller->users()) {
-    CallSite Site(U);
-    if (!Site)
-      continue;
-    Instruction *I = Site.getInstruction();
-    if (I->getFunction() == Caller) {
-      IsCallerRecursive = true;
-      break;
-    }
-  }
-
+/// Returns false if the walk found that the call site must not be inlined, and
+/// true otherwise, including when it stopped because the threshold was
+/// crossed.
+InlineResult CallAnalyzer::analyzeBody(CallSite CS) {
   // Populate our simplified values by mapping from function arguments to call
   // arguments with known important simplifications.
   CallSite::arg_iterator CAI = CS.arg_begin();
@@ -1805,11 +1783,11 @@ InlineResult CallAnalyzer::analyzeCall(CallSite CS) {
       BBSetVector;
   BBSetVector BBWorklist;
   BBWorklist.insert(&F.getEntryBlock());
-  bool SingleBB = true;
   // Note that we *must not* cache the size, this loop grows the worklist.
   for (unsigned Idx = 0; Idx != BBWorklist.size(); ++Idx) {
     // Bail out the moment we cross the threshold. This means we'll under-count
     // the cost, but only when undercounting doesn't matter.
+    noteCostCheck(Cost);
     if (Cost >= Threshold && !ComputeFullInlineCost)
       break;
 
@@ -1823,8 +1801,11 @@ InlineResult CallAnalyzer::analyzeCall(CallSite CS) {
     // see an indirect branch that ends up being dead code at a particular call
     // site. If the blockaddress escapes the function, e.g., via a global
     // variable, inlining may lead to an invalid cross-function reference.
-    if (BB->hasAddressTaken())
+    if (BB->hasAddressTaken()) {
+      if (Recording)
+        Recording->Failure = InlineCostSummaries::Other;
       return "blockaddress";
+    }
 
     // Analyze the cost of this block. If we blow through the threshold, this
     // returns false, and we can bail on out.
@@ -1877,6 +1858,244 @@ InlineResult CallAnalyzer::analyzeCall(CallSite CS) {
     }
   }
 
+  return true;
+}
+
+void CallAnalyzer::noteCostCheck(int64_t CheckedCost) {
+  if (!Recording)
+    return;
+  int64_t &MaxCheckedCost = SingleBB ? Recording->MaxCheckedCostSingleBB
+                                     : Recording->MaxCheckedCostMultiBB;
+  MaxCheckedCost = std::max(MaxCheckedCost, CheckedCost - WalkStartCost);
+}
+
+void CallAnalyzer::emitFailureRemark(InlineCostSummaries::FailureKind Kind,
+                                     InlineResult IR) {
+  using namespace ore;
+  if (!ORE)
+    return;
+  if (Kind == InlineCostSummaries::UninlinablePattern)
+    ORE->emit([&]() {
+      return OptimizationRemarkMissed(DEBUG_TYPE, "NeverInline",
+                                      CandidateCS.getInstruction())
+             << NV("Callee", &F) << " has uninlinable pattern ("
+             << NV("InlineResult", IR.message)
+             << ") and cost is not fully computed";
+    });
+  else if (Kind == InlineCostSummaries::RecursiveStackSize)
+    ORE->emit([&]() {
+      return OptimizationRemarkMissed(DEBUG_TYPE, "NeverInline",
+                                      CandidateCS.getInstruction())
+             << NV("Callee", &F) << " is " << NV("InlineResult", IR.message)
+             << ". Cost is not fully computed";
+    });
+}
+
+/// Compute what the call site \p CS tells the walk of the callee body about
+/// the arguments.
+InlineCostSummaries::Key CallAnalyzer::getSummaryKey(CallSite CS) {
+  InlineCostSummaries::Key K;
+  K.CallerIsRecursive = IsCallerRecursive;
+  SmallVector<Value *, 4> Bases;
+  for (unsigned I = 0, E = F.arg_size(); I != E; ++I) {
+    K.Args.emplace_back();
+    InlineCostSummaries::ArgumentInfo &Info = K.Args.back();
+    Value *Arg = CS.getArgument(I);
+    if (auto *C = dyn_cast<Constant>(Arg)) {
+      Info.C = C;
+      Info.IsConstant = true;
+    }
+    Info.NonNull = CS.paramHasAttr(I, Attribute::NonNull);
+
+    Value *Base = Arg;
+    ConstantInt *Offset = stripAndComputeInBoundsConstantOffsets(Base);
+    Bases.push_back(Offset ? Base : nullptr);
+    if (!Offset)
+      continue;
+    Info.IsPointer = true;
+    Info.Offset = Offset->getValue();
+    Info.BaseIsAlloca = isa<AllocaInst>(Base);
+    if (isa<Constant>(Base))
+      Info.ConstantBase = Base;
+    else
+      Info.BaseIndex = find(Bases, Base) - Bases.begin();
+  }
+  return K;
+}
+
+/// The largest threshold updateThreshold can give a call site with these
+/// parameters and the profile information at hand, with the single block and
+/// vector bonuses of analyzeCall. Only the bonus for the last call to a local
+/// function can take it further.
+int CallAnalyzer::getMaxThreshold() {
+  int MaxThreshold = Params.DefaultThreshold;
+  bool HasProfile = PSI && PSI->hasProfileSummary();
+  if ((F.hasFnAttribute(Attribute::InlineHint) || HasProfile) &&
+      Params.HintThreshold)
+    MaxThreshold = std::max(MaxThreshold, *Params.HintThreshold);
+  if (HasProfile && Params.HotCallSiteThreshold)
+    MaxThreshold = std::max(MaxThreshold, *Params.HotCallSiteThreshold);
+  if (GetBFI && Params.LocallyHotCallSiteThreshold)
+    MaxThreshold = std::max(MaxThreshold, *Params.LocallyHotCallSiteThreshold);
+  MaxThreshold *= TTI.getInliningThresholdMultiplier();
+  // The bonuses are at most 50% and 150% of the threshold.
+  return MaxThreshold * 3;
+}
+
+/// Walk the body of the callee like analyzeBody, but reuse the summary of an
+/// earlier walk for call sites like \p CS if there is one, and record one
+/// otherwise.
+InlineResult CallAnalyzer::analyzeBodyWithSummaries(CallSite CS) {
+  InlineCostSummaries::Key K = getSummaryKey(CS);
+  InlineCostSummaries::Summary NewSummary;
+  const InlineCostSummaries::Summary *S = Summaries->lookup(K);
+  if (!S) {
+    // Walk the body until the cost passes the largest threshold a call site
+    // like this one can have, so that the summary holds for all of them. The
+    // whole body is only walked if the full cost is needed. The single block
+    // bonus is left out of the limit so that it does not depend on where the
+    // walk finds a second block.
+    int StartCost = Cost;
+    int StartThreshold = Threshold;
+    int StartSingleBBBonus = SingleBBBonus;
+    int64_t CostLimit = std::max(getMaxThreshold(), Threshold) - StartCost;
+    if (!ComputeFullInlineCost)
+      Threshold = std::max(getMaxThreshold(), Threshold);
+    SingleBBBonus = 0;
+    Recording = &NewSummary;
+    WalkStartCost = Cost;
+    InlineResult IR = analyzeBody(CS);
+    Recording = nullptr;
+    SingleBBBonus = StartSingleBBBonus;
+
+    NewSummary.Cost = Cost - StartCost;
+    NewSummary.CostLimitExceeded =
+        !ComputeFullInlineCost &&
+        std::max(NewSummary.MaxCheckedCostSingleBB,
+                 NewSummary.MaxCheckedCostMultiBB) >= CostLimit;
+    NewSummary.NumInstructions = NumInstructions;
+    NewSummary.NumVectorInstructions = NumVectorInstructions;
+    NewSummary.SingleBB = SingleBB;
+    NewSummary.ContainsNoDuplicateCall = ContainsNoDuplicateCall;
+    NewSummary.FailureMessage = IR.message;
+
+    // The rest of the analysis goes on from the summary, as for a call site
+    // that finds it.
+    Cost = StartCost;
+    Threshold = StartThreshold;
+    SingleBB = true;
+    // Don't keep the summary if the walk depends on the body of a function
+    // the summaries are not invalidated for.
+    if (AnalyzedOtherFunction)
+      S = &NewSummary;
+    else
+      S = &Summaries->insert(std::move(K), NewSummary);
+  } else {
+    ++NumCallsSummarized;
+  }
+
+  // Without the full cost, the walk stops at the first check of the cost
+  // against the threshold that fails. The checks before the callee is found
+  // to have more than one block are against the threshold with the single
+  // block bonus, and those after against the threshold without it. Stopping
+  // is all that matters then: the call site is rejected as too costly.
+  if (!ComputeFullInlineCost) {
+    int64_t StartCost = Cost;
+    if (StartCost + S->MaxCheckedCostSingleBB >= Threshold) {
+      Cost = StartCost + S->MaxCheckedCostSingleBB;
+      return false;
+    }
+    if (StartCost + S->MaxCheckedCostMultiBB >=
+        (int64_t)Threshold - SingleBBBonus) {
+      Threshold -= SingleBBBonus;
+      Cost = StartCost + S->MaxCheckedCostMultiBB;
+      return false;
+    }
+  }
+
+  // The summary stops short of where the walk for this call site would, so
+  // walk the body for it alone.
+  if (S->CostLimitExceeded)
+    return analyzeBody(CS);
+
+  Cost += S->Cost;
+  NumInstructions = S->NumInstructions;
+  NumVectorInstructions = S->NumVectorInstructions;
+  ContainsNoDuplicateCall = S->ContainsNoDuplicateCall;
+  SingleBB = S->SingleBB;
+  if (!SingleBB)
+    Threshold -= SingleBBBonus;
+  if (S->Failure == InlineCostSummaries::NoFailure)
+    return true;
+  InlineResult IR = S->FailureMessage;
+  emitFailureRemark(S->Failure, IR);
+  return IR;
+}
+
+/// Analyze a call site for potential inlining.
+///
+/// Returns true if inlining this call is viable, and false if it is not
+/// viable. It computes the cost and adjusts the threshold based on numerous
+/// factors and heuristics. If this method returns false but the computed cost
+/// is below the computed threshold, then inlining was forcibly disabled by
+/// some artifact of the routine.
+InlineResult CallAnalyzer::analyzeCall(CallSite CS) {
+  ++NumCallsAnalyzed;
+
+  // Perform some tweaks to the cost and threshold based on the direct
+  // callsite information.
+
+  // We want to more aggressively inline vector-dense kernels, so up the
+  // threshold, and we'll lower it if the % of vector instructions gets too
+  // low. Note that these bonuses are some what arbitrary and evolved over time
+  // by accident as much as because they are principled bonuses.
+  //
+  // FIXME: It would be nice to remove all such bonuses. At least it would be
+  // nice to base the bonus values on something more scientific.
+  assert(NumInstructions == 0);
+  assert(NumVectorInstructions == 0);
+
+  // Update the threshold based on callsite properties
+  updateThreshold(CS, F);
+
+  // Speculatively apply all possible bonuses to Threshold. If cost exceeds
+  // this Threshold any time, and cost cannot decrease, we can stop processing
+  // the rest of the function body.
+  Threshold += (SingleBBBonus + VectorBonus);
+
+  // Give out bonuses for the callsite, as the instructions setting them up
+  // will be gone after inlining.
+  Cost -= getCallsiteCost(CS, DL);
+
+  // If this function uses the coldcc calling convention, prefer not to inline
+  // it.
+  if (F.getCallingConv() == CallingConv::Cold)
+    Cost += InlineConstants::ColdccPenalty;
+
+  // Check if we're done. This can happen due to bonuses and penalties.
+  if (Cost >= Threshold && !ComputeFullInlineCost)
+    return "high cost";
+
+  if (F.empty())
+    return true;
+
+  Function *Caller = CS.getInstruction()->getFunction();
+  // Check if the caller function is recursive itself.
+  for (User *U : Caller->users()) {
+    CallSite Site(U);
+    if (!Site)
+      continue;
+    Instruction *I = Site.getInstruction();
+    if (I->getFunction() == Caller) {
+      IsCallerRecursive = true;
+      break;
+    }
+  }
+
+  InlineResult IR = Summaries ? analyzeBodyWithSummaries(CS) : analyzeBody(CS);
+  if (!IR)
+    return IR;
+
   bool OnlyOneCallAndLocalLinkage =
       F.hasLocalLinkage() && F.hasOneUse() && &F == CS.getCalledFunction();
   // If this is a noduplicate call, we can still inline as long as
@@ -1959,13 +2178,36 @@ int llvm::getCallsiteCost(CallSite CS, const DataLayout &DL) {
   return Cost;
 }
 
+AnalysisKey InlineCostSummaryAnalysis::Key;
+
+const InlineCostSummaries::Summary *
+InlineCostSummaries::lookup(const Key &K) const {
+  for (const auto &Entry : Entries)
+    if (Entry.first == K)
+      return &Entry.second;
+  return nullptr;
+}
+
+const InlineCostSummaries::Summary &
+InlineCostSummaries::insert(Key K, const Summary &S) {
+  // Callees are mostly called with a few argument patterns. Past that, the
+  // last summary is replaced rather than keeping one for each of the many
+  // constants a callee may be called with.
+  const unsigned MaxSummaries = 8;
+  if (Entries.size() == MaxSummaries)
+    Entries.pop_back();
+  Entries.emplace_back(std::move(K), S);
+  return Entries.back().second;
+}
+
 InlineCost llvm::getInlineCost(
     CallSite CS, const InlineParams &Params, TargetTransformInfo &CalleeTTI,
     std::function<AssumptionCache &(Function &)> &GetAssumptionCache,
     Optional<function_ref<BlockFrequencyInfo &(Function &)>> GetBFI,
-    ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE) {
+    ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE,
+    InlineCostSummaries *CalleeSummaries) {
   return getInlineCost(CS, CS.getCalledFunction(), Params, CalleeTTI,
-                       GetAssumptionCache, GetBFI, PSI, ORE);
+                       GetAssumptionCache, GetBFI, PSI, ORE, CalleeSummaries);
 }
 
 InlineCost llvm::getInlineCost(
@@ -1973,7 +2215,8 @@ InlineCost llvm::getInlineCost(
     TargetTransformInfo &CalleeTTI,
     std::function<AssumptionCache &(Function &)> &GetAssumptionCache,
     Optional<function_ref<BlockFrequencyInfo &(Function &)>> GetBFI,
-    ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE) {
+    ProfileSummaryInfo *PSI, OptimizationRemarkEmitter *ORE,
+    InlineCostSummaries *CalleeSummaries) {
 
   // Cannot inline indirect calls.
   if (!Callee)
@@ -2032,7 +2275,7 @@ InlineCost llvm::getInlineCost(
                           << "... (caller:" << Caller->getName() << ")\n");
 
   CallAnalyzer CA(CalleeTTI, GetAssumptionCache, GetBFI, PSI, ORE, *Callee, CS,
-                  Params);
+                  Params, CalleeSummaries);
   InlineResult ShouldInline = CA.analyzeCall(CS);
 
   LLVM_DEBUG(CA.dump());
@@ -788,12 +788,15 @@ static void GroupByComplexity(SmallVectorImpl<const SCEV *> &Ops,
     return;
   }
 
-  // Do the rough sort by complexity.
-  std::stable_sort(Ops.begin(), Ops.end(),
-                   [&](const SCEV *LHS, const SCEV *RHS) {
-                     return CompareSCEVComplexity(EqCacheSCEV, EqCacheValue, LI,
-                                                  LHS, RHS, DT) < 0;
-                   });
+  // Do the rough sort by complexity. Operands taken from existing
+  // expressions are often in order already, and checking for that is cheaper
+  // than sorting them again.
+  auto IsLessComplex = [&](const SCEV *LHS, const SCEV *RHS) {
+    return CompareSCEVComplexity(EqCacheSCEV, EqCacheValue, LI, LHS, RHS, DT) <
+           0;
+  };
+  if (!std::is_sorted(Ops.begin(), Ops.end(), IsLessComplex))
+    std::stable_sort(Ops.begin(), Ops.end(), IsLessComplex);
 
   // Now that we are sorted by complexity, group elements of the same
   // complexity.  Note that this is, at worst, N^2, but the vector is likely to
@@ -1290,6 +1293,7 @@ const SCEV *ScalarEvolution::getTruncateExpr(const SCEV *Op,
                                                  Op, Ty);
   UniqueSCEVs.InsertNode(S, IP);
   addToLoopUseLists(S);
+  registerUser(S);
   return S;
 }
 
@@ -1618,6 +1622,7 @@ ScalarEvolution::getZeroExtendExpr(const SCEV *Op, Type *Ty, unsigned Depth) {
                                                      Op, Ty);
     UniqueSCEVs.InsertNode(S, IP);
     addToLoopUseLists(S);
+    registerUser(S);
     return S;
   }
 
@@ -1891,6 +1896,7 @@ ScalarEvolution::getZeroExtendExpr(const SCEV *Op, Type *Ty, unsigned Depth) {
                                                    Op, Ty);
   UniqueSCEVs.InsertNode(S, IP);
   addToLoopUseLists(S);
+  registerUser(S);
   return S;
 }
 
@@ -1929,6 +1935,7 @@ ScalarEvolution::getSignExtendExpr(const SCEV *Op, Type *Ty, unsigned Depth) {
                                                      Op, Ty);
     UniqueSCEVs.InsertNode(S, IP);
     addToLoopUseLists(S);
+    registerUser(S);
     return S;
   }
 
@@ -2143,6 +2150,7 @@ ScalarEvolution::getSignExtendExpr(const SCEV *Op, Type *Ty, unsigned Depth) {
                                                    Op, Ty);
   UniqueSCEVs.InsertNode(S, IP);
   addToLoopUseLists(S);
+  registerUser(S);
   return S;
 }
 
@@ -2402,6 +2410,13 @@ const SCEV *ScalarEvolution::getAddExpr(SmallVectorImpl<const SCEV *> &Ops,
   if (Depth > MaxArithDepth)
     return getOrCreateAddExpr(Ops, Flags);
 
+  // An add of exactly these operands was created by an earlier call that
+  // already did the folding below, so return it instead of folding again.
+  if (SCEV *S = findExistingSCEVInCache(scAddExpr, Ops)) {
+    static_cast<SCEVAddExpr *>(S)->setNoWrapFlags(Flags);
+    return S;
+  }
+
   // Okay, check to see if the same value occurs in the operand list more than
   // once.  If so, merge them together into an multiply expression.  Since we
   // sorted the list, these values are required to be adjacent.
@@ -2736,6 +2751,16 @@ const SCEV *ScalarEvolution::getAddExpr(SmallVectorImpl<const SCEV *> &Ops,
   return getOrCreateAddExpr(Ops, Flags);
 }
 
+SCEV *ScalarEvolution::findExistingSCEVInCache(int SCEVType,
+                                               ArrayRef<const SCEV *> Ops) {
+  FoldingSetNodeID ID;
+  ID.AddInteger(SCEVType);
+  for (const SCEV *Op : Ops)
+    ID.AddPointer(Op);
+  void *IP = nullptr;
+  return UniqueSCEVs.FindNodeOrInsertPos(ID, IP);
+}
+
 const SCEV *
 ScalarEvolution::getOrCreateAddExpr(SmallVectorImpl<const SCEV *> &Ops,
                                     SCEV::NoWrapFlags Flags) {
@@ -2753,6 +2778,7 @@ ScalarEvolution::getOrCreateAddExpr(SmallVectorImpl<const SCEV *> &Ops,
         SCEVAddExpr(ID.Intern(SCEVAllocator), O, Ops.size());
     UniqueSCEVs.InsertNode(S, IP);
     addToLoopUseLists(S);
+    registerUser(S);
   }
   S->setNoWrapFlags(Flags);
   return S;
@@ -2775,6 +2801,7 @@ ScalarEvolution::getOrCreateMulExpr(SmallVectorImpl<const SCEV *> &Ops,
                                         O, Ops.size());
     UniqueSCEVs.InsertNode(S, IP);
     addToLoopUseLists(S);
+    registerUser(S);
   }
   S->setNoWrapFlags(Flags);
   return S;
@@ -2858,6 +2885,13 @@ const SCEV *ScalarEvolution::getMulExpr(SmallVectorImpl<const SCEV *> &Ops,
   if (Depth > MaxArithDepth)
     return getOrCreateMulExpr(Ops, Flags);
 
+  // A multiply of exactly these operands was created by an earlier call that
+  // already did the folding below, so return it instead of folding again.
+  if (SCEV *S = findExistingSCEVInCache(scMulExpr, Ops)) {
+    static_cast<SCEVMulExpr *>(S)->setNoWrapFlags(Flags);
+    return S;
+  }
+
   // If there are any constants, fold them together.
   unsigned Idx = 0;
   if (const SCEVConstant *LHSC = dyn_cast<SCEVConstant>(Ops[0])) {
@@ -3242,6 +3276,7 @@ const SCEV *ScalarEvolution::getUDivExpr(const SCEV *LHS,
                                              LHS, RHS);
   UniqueSCEVs.InsertNode(S, IP);
   addToLoopUseLists(S);
+  registerUser(S);
   return S;
 }
 
@@ -3423,6 +3458,7 @@ ScalarEvolution::getAddRecExpr(SmallVectorImpl<const SCEV *> &Operands,
                                            O, Operands.size(), L);
     UniqueSCEVs.InsertNode(S, IP);
     addToLoopUseLists(S);
+    registerUser(S);
   }
   S->setNoWrapFlags(Flags);
   return S;
@@ -3579,6 +3615,7 @@ ScalarEvolution::getSMaxExpr(SmallVectorImpl<const SCEV *> &Ops) {
                                              O, Ops.size());
   UniqueSCEVs.InsertNode(S, IP);
   addToLoopUseLists(S);
+  registerUser(S);
   return S;
 }
 
@@ -3682,6 +3719,7 @@ ScalarEvolution::getUMaxExpr(SmallVectorImpl<const SCEV *> &Ops) {
                                              O, Ops.size());
   UniqueSCEVs.InsertNode(S, IP);
   addToLoopUseLists(S);
+  registerUser(S);
   return S;
 }
 
@@ -6624,6 +6662,7 @@ ScalarEvolution::getPredicatedBackedgeTakenInfo(const Loop *L) {
 
   BackedgeTakenInfo Result =
       computeBackedgeTakenCount(L, /*AllowPredicates=*/true);
+  registerBECountUsers(L, Result, /*Predicated=*/true);
 
   return PredicatedBackedgeTakenCounts.find(L)->second = std::move(Result);
 }
@@ -6728,30 +6767,23 @@ ScalarEvolution::getBackedgeTakenInfo(const Loop *L) {
   // recusive call to getBackedgeTakenInfo (on a different
   // loop), which would invalidate the iterator computed
   // earlier.
+  registerBECountUsers(L, Result, /*Predicated=*/false);
   return BackedgeTakenCounts.find(L)->second = std::move(Result);
 }
 
 void ScalarEvolution::forgetLoop(const Loop *L) {
-  // Drop any stored trip count value.
-  auto RemoveLoopFromBackedgeMap =
-      [](DenseMap<const Loop *, BackedgeTakenInfo> &Map, const Loop *L) {
-        auto BTCPos = Map.find(L);
-        if (BTCPos != Map.end()) {
-          BTCPos->second.clear();
-          Map.erase(BTCPos);
-        }
-      };
-
   SmallVector<const Loop *, 16> LoopWorklist(1, L);
   SmallVector<Instruction *, 32> Worklist;
   SmallPtrSet<Instruction *, 16> Visited;
+  SmallVector<const SCEV *, 16> ToForget;
 
   // Iterate over all the loops and sub-loops to drop SCEV information.
   while (!LoopWorklist.empty()) {
     auto *CurrL = LoopWorklist.pop_back_val();
 
-    RemoveLoopFromBackedgeMap(BackedgeTakenCounts, CurrL);
-    RemoveLoopFromBackedgeMap(PredicatedBackedgeTakenCounts, CurrL);
+    // Drop any stored trip count value.
+    eraseBackedgeTakenInfo(BackedgeTakenCounts, CurrL);
+    eraseBackedgeTakenInfo(PredicatedBackedgeTakenCounts, CurrL);
 
     // Drop information about predicated SCEV rewrites for this loop.
     for (auto I = PredicatedSCEVRewrites.begin();
@@ -6765,8 +6797,8 @@ void ScalarEvolution::forgetLoop(const Loop *L) {
 
     auto LoopUsersItr = LoopUsers.find(CurrL);
     if (LoopUsersItr != LoopUsers.end()) {
-      for (auto *S : LoopUsersItr->second)
-        forgetMemoizedResults(S);
+      ToForget.append(LoopUsersItr->second.begin(),
+                      LoopUsersItr->second.end());
       LoopUsers.erase(LoopUsersItr);
     }
 
@@ -6782,7 +6814,7 @@ void ScalarEvolution::forgetLoop(const Loop *L) {
           ValueExprMap.find_as(static_cast<Value *>(I));
       if (It != ValueExprMap.end()) {
         eraseValueFromMap(It->first);
-        forgetMemoizedResults(It->second);
+        ToForget.push_back(It->second);
         if (PHINode *PN = dyn_cast<PHINode>(I))
           ConstantEvolutionLoopExitValue.erase(PN);
       }
@@ -6795,6 +6827,7 @@ void ScalarEvolution::forgetLoop(const Loop *L) {
     // ValuesAtScopes map.
     LoopWorklist.append(CurrL->begin(), CurrL->end());
   }
+  forgetMemoizedResults(ToForget);
 }
 
 void ScalarEvolution::forgetTopmostLoop(const Loop *L) {
@@ -6812,6 +6845,7 @@ void ScalarEvolution::forgetValue(Value *V) {
   Worklist.push_back(I);
 
   SmallPtrSet<Instruction *, 8> Visited;
+  SmallVector<const SCEV *, 8> ToForget;
   while (!Worklist.empty()) {
     I = Worklist.pop_back_val();
     if (!Visited.insert(I).second)
@@ -6821,13 +6855,14 @@ void ScalarEvolution::forgetValue(Value *V) {
       ValueExprMap.find_as(static_cast<Value *>(I));
     if (It != ValueExprMap.end()) {
       eraseValueFromMap(It->first);
-      forgetMemoizedResults(It->second);
+      ToForget.push_back(It->second);
       if (PHINode *PN = dyn_cast<PHINode>(I))
         ConstantEvolutionLoopExitValue.erase(PN);
     }
 
     PushDefUseChildren(I, Worklist);
   }
+  forgetMemoizedResults(ToForget);
 }
 
 /// Get the exact loop backedge taken count considering all loop exits. A
@@ -6903,18 +6938,14 @@ bool ScalarEvolution::BackedgeTakenInfo::isMaxOrZero(ScalarEvolution *SE) const
   return MaxOrZero && !any_of(ExitNotTaken, PredicateNotAlwaysTrue);
 }
 
-bool ScalarEvolution::BackedgeTakenInfo::hasOperand(const SCEV *S,
-                                                    ScalarEvolution *SE) const {
-  if (getMax() && getMax() != SE->getCouldNotCompute() &&
-      SE->hasOperand(getMax(), S))
-    return true;
+void ScalarEvolution::BackedgeTakenInfo::getExprs(
+    SmallVectorImpl<const SCEV *> &Exprs) const {
+  if (getMax() && !isa<SCEVCouldNotCompute>(getMax()))
+    Exprs.push_back(getMax());
 
   for (auto &ENT : ExitNotTaken)
-    if (ENT.ExactNotTaken != SE->getCouldNotCompute() &&
-        SE->hasOperand(ENT.ExactNotTaken, S))
-      return true;
-
-  return false;
+    if (!isa<SCEVCouldNotCompute>(ENT.ExactNotTaken))
+      Exprs.push_back(ENT.ExactNotTaken);
 }
 
 ScalarEvolution::ExitLimit::ExitLimit(const SCEV *E)
@@ -11339,6 +11370,8 @@ ScalarEvolution::ScalarEvolution(ScalarEvolution &&Arg)
       UniquePreds(std::move(Arg.UniquePreds)),
       SCEVAllocator(std::move(Arg.SCEVAllocator)),
       LoopUsers(std::move(Arg.LoopUsers)),
+      SCEVUsers(std::move(Arg.SCEVUsers)),
+      BECountUsers(std::move(Arg.BECountUsers)),
       PredicatedSCEVRewrites(std::move(Arg.PredicatedSCEVRewrites)),
       FirstUnknown(Arg.FirstUnknown) {
   Arg.FirstUnknown = nullptr;
@@ -11743,39 +11776,104 @@ bool ScalarEvolution::ExitLimit::hasOperand(const SCEV *S) const {
 }
 
 void
-ScalarEvolution::forgetMemoizedResults(const SCEV *S) {
-  ValuesAtScopes.erase(S);
-  LoopDispositions.erase(S);
-  BlockDispositions.erase(S);
-  UnsignedRanges.erase(S);
-  SignedRanges.erase(S);
-  ExprValueMap.erase(S);
-  HasRecMap.erase(S);
-  MinTrailingZerosCache.erase(S);
+ScalarEvolution::forgetMemoizedResults(ArrayRef<const SCEV *> SCEVs) {
+  if (SCEVs.empty())
+    return;
+
+  SmallPtrSet<const SCEV *, 8> ToForget(SCEVs.begin(), SCEVs.end());
+  for (const SCEV *S : ToForget) {
+    ValuesAtScopes.erase(S);
+    LoopDispositions.erase(S);
+    BlockDispositions.erase(S);
+    UnsignedRanges.erase(S);
+    SignedRanges.erase(S);
+    ExprValueMap.erase(S);
+    HasRecMap.erase(S);
+    MinTrailingZerosCache.erase(S);
+  }
 
   for (auto I = PredicatedSCEVRewrites.begin();
        I != PredicatedSCEVRewrites.end();) {
     std::pair<const SCEV *, const Loop *> Entry = I->first;
-    if (Entry.first == S)
+    if (ToForget.count(Entry.first))
       PredicatedSCEVRewrites.erase(I++);
     else
       ++I;
   }
 
-  auto RemoveSCEVFromBackedgeMap =
-      [S, this](DenseMap<const Loop *, BackedgeTakenInfo> &Map) {
-        for (auto I = Map.begin(), E = Map.end(); I != E;) {
-          BackedgeTakenInfo &BEInfo = I->second;
-          if (BEInfo.hasOperand(S, this)) {
-            BEInfo.clear();
-            Map.erase(I++);
-          } else
-            ++I;
-        }
-      };
+  if (BECountUsers.empty())
+    return;
+
+  // A backedge taken count has to be dropped if it contains any of the
+  // forgotten expressions, i.e. if it is one of their transitive users.
+  SmallPtrSet<const SCEV *, 16> Visited(ToForget.begin(), ToForget.end());
+  SmallVector<const SCEV *, 16> Worklist(ToForget.begin(), ToForget.end());
+  SmallVector<PointerIntPair<const Loop *, 1, bool>, 4> LoopsToForget;
+  while (!Worklist.empty()) {
+    const SCEV *Curr = Worklist.pop_back_val();
+    auto BEUsers = BECountUsers.find(Curr);
+    if (BEUsers != BECountUsers.end())
+      LoopsToForget.append(BEUsers->second.begin(), BEUsers->second.end());
+    auto Users = SCEVUsers.find(Curr);
+    if (Users != SCEVUsers.end())
+      for (const SCEV *User : Users->second)
+        if (Visited.insert(User).second)
+          Worklist.push_back(User);
+  }
+
+  for (PointerIntPair<const Loop *, 1, bool> LoopAndPredicated : LoopsToForget)
+    eraseBackedgeTakenInfo(LoopAndPredicated.getInt()
+                               ? PredicatedBackedgeTakenCounts
+                               : BackedgeTakenCounts,
+                           LoopAndPredicated.getPointer());
+}
+
+void ScalarEvolution::registerUser(const SCEV *User) {
+  auto AddUser = [&](const SCEV *Op) { SCEVUsers[Op].insert(User); };
+  if (auto *Cast = dyn_cast<SCEVCastExpr>(User)) {
+    AddUser(Cast->getOperand());
+  } else if (auto *NAry = dyn_cast<SCEVNAryExpr>(User)) {
+    for (const SCEV *Op : NAry->operands())
+      AddUser(Op);
+  } else if (auto *UDiv = dyn_cast<SCEVUDivExpr>(User)) {
+    AddUser(UDiv->getLHS());
+    AddUser(UDiv->getRHS());
+  }
+}
+
+void ScalarEvolution::registerBECountUsers(const Loop *L,
+                                           const BackedgeTakenInfo &BTI,
+                                           bool Predicated) {
+  SmallVector<const SCEV *, 4> Exprs;
+  BTI.getExprs(Exprs);
+  for (const SCEV *S : Exprs)
+    BECountUsers[S].insert({L, Predicated});
+}
+
+void ScalarEvolution::unregisterBECountUsers(const Loop *L,
+                                             const BackedgeTakenInfo &BTI,
+                                             bool Predicated) {
+  SmallVector<const SCEV *, 4> Exprs;
+  BTI.getExprs(Exprs);
+  for (const SCEV *S : Exprs) {
+    auto It = BECountUsers.find(S);
+    if (It == BECountUsers.end())
+      continue;
+    It->second.erase({L, Predicated});
+    if (It->second.empty())
+      BECountUsers.erase(It);
+  }
+}
 
-  RemoveSCEVFromBackedgeMap(BackedgeTakenCounts);
-  RemoveSCEVFromBackedgeMap(PredicatedBackedgeTakenCounts);
+void ScalarEvolution::eraseBackedgeTakenInfo(
+    DenseMap<const Loop *, BackedgeTakenInfo> &Map, const Loop *L) {
+  auto BTCPos = Map.find(L);
+  if (BTCPos == Map.end())
+    return;
+  unregisterBECountUsers(L, BTCPos->second,
+                         &Map == &PredicatedBackedgeTakenCounts);
+  BTCPos->second.clear();
+  Map.erase(BTCPos);
 }
 
 void
@@ -98,11 +98,13 @@ bool Legalizer::runOnMachineFunction(MachineFunction &MF) {
       if (!isPreISelGenericOpcode(MI.getOpcode()))
         continue;
       if (isArtifact(MI))
-        ArtifactList.insert(&MI);
+        ArtifactList.deferred_insert(&MI);
       else
-        InstList.insert(&MI);
+        InstList.deferred_insert(&MI);
     }
   }
+  ArtifactList.finalize();
+  InstList.finalize();
   Helper.MIRBuilder.recordInsertions([&](MachineInstr *MI) {
     // Only legalize pre-isel generic instructions.
     // Legalization process could generate Target specific pseudo
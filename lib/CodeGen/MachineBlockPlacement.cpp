@@ -312,6 +312,89 @@ public:
   unsigned UnscheduledPredecessors = 0;
 };
 
+/// A work list of blocks which are ready to be laid out.
+///
+/// Rescanning every block ever added to the list each time a candidate is
+/// needed is quadratic on functions with many thousands of blocks (e.g.
+/// switch-heavy interpreter loops). The candidates are instead kept in a
+/// binary heap keyed on their block frequency, which does not change during
+/// placement. Entries for blocks which have since been placed in the chain
+/// being built are discarded lazily when they reach the top of the heap.
+///
+/// Ties are broken by insertion order: among equally hot blocks the first one
+/// added wins, while among equally cold EH pads the last one added wins.
+class CandidateWorkList {
+  struct Entry {
+    BlockFrequency Freq;
+    unsigned Order;
+    MachineBasicBlock *MBB;
+  };
+
+  /// Whether this list holds EH pads, which are laid out coldest first.
+  bool IsEHPad;
+
+  /// Number of blocks pushed so far, used to order equally hot entries.
+  unsigned NextOrder = 0;
+
+  /// Heap comparator: returns true if \p LHS is a worse candidate than
+  /// \p RHS.
+  struct WorseThan {
+    bool IsEHPad;
+
+    bool operator()(const Entry &LHS, const Entry &RHS) const {
+      if (LHS.Freq == RHS.Freq)
+        return IsEHPad ? LHS.Order < RHS.Order : LHS.Order > RHS.Order;
+      return IsEHPad ? LHS.Freq > RHS.Freq : LHS.Freq < RHS.Freq;
+    }
+  };
+
+  /// The candidates, kept as a max-heap under WorseThan.
+  std::vector<Entry> Heap;
+
+  WorseThan worseThan() const { return WorseThan{IsEHPad}; }
+
+public:
+  explicit CandidateWorkList(bool IsEHPad) : IsEHPad(IsEHPad) {}
+
+  bool empty() const { return Heap.empty(); }
+
+  void clear() {
+    Heap.clear();
+    NextOrder = 0;
+  }
+
+  void push(MachineBasicBlock *MBB, BlockFrequency Freq) {
+    assert(MBB->isEHPad() == IsEHPad &&
+           "EHPad mismatch between block and work list.");
+    Heap.push_back({Freq, NextOrder++, MBB});
+    std::push_heap(Heap.begin(), Heap.end(), worseThan());
+  }
+
+  /// Remove all entries for \p MBB, e.g. because it has been deleted.
+  void erase(const MachineBasicBlock *MBB) {
+    auto NewEnd = llvm::remove_if(
+        Heap, [MBB](const Entry &E) { return E.MBB == MBB; });
+    if (NewEnd == Heap.end())
+      return;
+    Heap.erase(NewEnd, Heap.end());
+    std::make_heap(Heap.begin(), Heap.end(), worseThan());
+  }
+
+  /// Return the best candidate which is not already part of \p Chain, or
+  /// null if there is none. Entries for blocks in \p Chain are dropped.
+  MachineBasicBlock *top(const BlockChain &Chain,
+                         const BlockToChainMapType &BlockToChain) {
+    while (!Heap.empty()) {
+      MachineBasicBlock *MBB = Heap.front().MBB;
+      if (BlockToChain.lookup(MBB) != &Chain)
+        return MBB;
+      std::pop_heap(Heap.begin(), Heap.end(), worseThan());
+      Heap.pop_back();
+    }
+    return nullptr;
+  }
+};
+
 class MachineBlockPlacement : public MachineFunctionPass {
   /// A type for a block filter set.
   using BlockFilterSet = SmallSetVector<const MachineBasicBlock *, 16>;
@@ -330,8 +413,8 @@ class MachineBlockPlacement : public MachineFunctionPass {
   };
 
   /// work lists of blocks that are ready to be laid out
-  SmallVector<MachineBasicBlock *, 16> BlockWorkList;
-  SmallVector<MachineBasicBlock *, 16> EHPadWorkList;
+  CandidateWorkList BlockWorkList{/*IsEHPad=*/false};
+  CandidateWorkList EHPadWorkList{/*IsEHPad=*/true};
 
   /// Edges that have already been computed as optimal.
   DenseMap<const MachineBasicBlock *, BlockAndTailDupResult> ComputedEdges;
@@ -435,7 +518,7 @@ class MachineBlockPlacement : public MachineFunctionPass {
       const MachineBasicBlock *BB, const BlockChain &Chain,
       const BlockFilterSet *BlockFilter);
   MachineBasicBlock *selectBestCandidateBlock(
-      const BlockChain &Chain, SmallVectorImpl<MachineBasicBlock *> &WorkList);
+      const BlockChain &Chain, CandidateWorkList &WorkList);
   MachineBasicBlock *getFirstUnplacedBlock(
       const BlockChain &PlacedChain,
       MachineFunction::iterator &PrevUnplacedBlockIt,
@@ -603,9 +686,9 @@ void MachineBlockPlacement::markBlockSuccessors(
 
     auto *NewBB = *SuccChain.begin();
     if (NewBB->isEHPad())
-      EHPadWorkList.push_back(NewBB);
+      EHPadWorkList.push(NewBB, MBFI->getBlockFreq(NewBB));
     else
-      BlockWorkList.push_back(NewBB);
+      BlockWorkList.push(NewBB, MBFI->getBlockFreq(NewBB));
   }
 }
 
@@ -1569,64 +1652,35 @@ MachineBlockPlacement::selectBestSuccessor(
 ///
 /// \returns The best block found, or null if none are viable.
 MachineBasicBlock *MachineBlockPlacement::selectBestCandidateBlock(
-    const BlockChain &Chain, SmallVectorImpl<MachineBasicBlock *> &WorkList) {
-  // Once we need to walk the worklist looking for a candidate, cleanup the
-  // worklist of already placed entries.
-  // FIXME: If this shows up on profiles, it could be folded (at the cost of
-  // some code complexity) into the loop below.
-  WorkList.erase(llvm::remove_if(WorkList,
-                                 [&](MachineBasicBlock *BB) {
-                                   return BlockToChain.lookup(BB) == &Chain;
-                                 }),
-                 WorkList.end());
-
-  if (WorkList.empty())
+    const BlockChain &Chain, CandidateWorkList &WorkList) {
+  // For ehpad, we layout the least probable first as to avoid jumping back
+  // from least probable landingpads to more probable ones. The work list is
+  // ordered accordingly.
+  //
+  // FIXME: Using probability is probably (!) not the best way to achieve
+  // this. We should probably have a more principled approach to layout
+  // cleanup code.
+  //
+  // The goal is to get:
+  //
+  //                 +--------------------------+
+  //                 |                          V
+  // InnerLp -> InnerCleanup    OuterLp -> OuterCleanup -> Resume
+  //
+  // Rather than:
+  //
+  //                 +-------------------------------------+
+  //                 V                                     |
+  // OuterLp -> OuterCleanup -> Resume     InnerLp -> InnerCleanup
+  MachineBasicBlock *BestBlock = WorkList.top(Chain, BlockToChain);
+  if (!BestBlock)
     return nullptr;
 
-  bool IsEHPad = WorkList[0]->isEHPad();
-
-  MachineBasicBlock *BestBlock = nullptr;
-  BlockFrequency BestFreq;
-  for (MachineBasicBlock *MBB : WorkList) {
-    assert(MBB->isEHPad() == IsEHPad &&
-           "EHPad mismatch between block and work list.");
-
-    BlockChain &SuccChain = *BlockToChain[MBB];
-    if (&SuccChain == &Chain)
-      continue;
-
-    assert(SuccChain.UnscheduledPredecessors == 0 &&
-           "Found CFG-violating block");
-
-    BlockFrequency CandidateFreq = MBFI->getBlockFreq(MBB);
-    LLVM_DEBUG(dbgs() << "    " << getBlockName(MBB) << " -> ";
-               MBFI->printBlockFreq(dbgs(), CandidateFreq) << " (freq)\n");
-
-    // For ehpad, we layout the least probable first as to avoid jumping back
-    // from least probable landingpads to more probable ones.
-    //
-    // FIXME: Using probability is probably (!) not the best way to achieve
-    // this. We should probably have a more principled approach to layout
-    // cleanup code.
-    //
-    // The goal is to get:
-    //
-    //                 +--------------------------+
-    //                 |                          V
-    // InnerLp -> InnerCleanup    OuterLp -> OuterCleanup -> Resume
-    //
-    // Rather than:
-    //
-    //                 +-------------------------------------+
-    //                 V                                     |
-    // OuterLp -> OuterCleanup -> Resume     InnerLp -> InnerCleanup
-    if (BestBlock && (IsEHPad ^ (BestFreq >= CandidateFreq)))
-      continue;
-
-    BestBlock = MBB;
-    BestFreq = CandidateFreq;
-  }
-
+  assert(BlockToChain[BestBlock]->UnscheduledPredecessors == 0 &&
+         "Found CFG-violating block");
+  LLVM_DEBUG(dbgs() << "    " << getBlockName(BestBlock) << " -> ";
+             MBFI->printBlockFreq(dbgs(), MBFI->getBlockFreq(BestBlock))
+             << " (freq)\n");
   return BestBlock;
 }
 
@@ -1684,9 +1738,9 @@ void MachineBlockPlacement::fillWorkLists(
 
   MachineBasicBlock *BB = *Chain.begin();
   if (BB->isEHPad())
-    EHPadWorkList.push_back(BB);
+    EHPadWorkList.push(BB, MBFI->getBlockFreq(BB));
   else
-    BlockWorkList.push_back(BB);
+    BlockWorkList.push(BB, MBFI->getBlockFreq(BB));
 }
 
 void MachineBlockPlacement::buildChain(
@@ -2674,15 +2728,10 @@ bool MachineBlockPlacement::maybeTailDuplicateBlock(
 
         // Handle the Work Lists
         if (InWorkList) {
-          SmallVectorImpl<MachineBasicBlock *> &RemoveList = BlockWorkList;
           if (RemBB->isEHPad())
-            RemoveList = EHPadWorkList;
-          RemoveList.erase(
-              llvm::remove_if(RemoveList,
-                              [RemBB](MachineBasicBlock *BB) {
-                                return BB == RemBB;
-                              }),
-              RemoveList.end());
+            EHPadWorkList.erase(RemBB);
+          else
+            BlockWorkList.erase(RemBB);
         }
 
         // Handle the filter set
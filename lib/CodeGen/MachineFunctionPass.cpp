@@ -27,6 +27,7 @@
 #include "llvm/CodeGen/Passes.h"
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/PassTimingInfo.h"
 
 using namespace llvm;
 using namespace ore;
@@ -66,13 +67,19 @@ bool MachineFunctionPass::runOnFunction(Function &F) {
   bool ShouldEmitSizeRemarks =
       F.getParent()->shouldEmitInstrCountChangedRemark();
 
+  // The per-function timing report also wants machine instruction counts.
+  FunctionPassTimingReport *TimingReport = FunctionPassTimingReport::get();
+
   // If we want size remarks, collect the number of MachineInstrs in our
   // MachineFunction before the pass runs.
-  if (ShouldEmitSizeRemarks)
+  if (ShouldEmitSizeRemarks || TimingReport)
     CountBefore = MF.getInstructionCount();
 
   bool RV = runOnMachineFunction(MF);
 
+  if (TimingReport)
+    TimingReport->setMachineInstrCounts(CountBefore, MF.getInstructionCount());
+
   if (ShouldEmitSizeRemarks) {
     // We wanted size remarks. Check if there was a change to the number of
     // MachineInstrs in the module. Emit a remark if there was a change.
@@ -167,6 +167,15 @@ static cl::opt<bool>
 static cl::opt<int> SwpLoopLimit("pipeliner-max", cl::Hidden, cl::init(-1));
 #endif
 
+/// A command line argument to bound the search for recurrences. Enumerating
+/// the elementary circuits of the dependence graph is exponential in the worst
+/// case, so give up on the loop once this many search steps have been taken.
+static cl::opt<unsigned> SwpMaxCircuitSteps(
+    "pipeliner-max-circuit-steps",
+    cl::desc("Maximum number of steps taken to find the recurrences of a "
+             "loop before giving up on pipelining it."),
+    cl::Hidden, cl::init(1000000));
+
 static cl::opt<bool> SwpIgnoreRecMII("pipeliner-ignore-recmii",
                                      cl::ReallyHidden, cl::init(false),
                                      cl::ZeroOrMore, cl::desc("Ignore RecMII"));
@@ -187,6 +196,10 @@ public:
   const TargetInstrInfo *TII = nullptr;
   RegisterClassInfo RegClassInfo;
 
+  /// Whether each subtarget seen so far has a packetizer DFA to model the
+  /// resources with.
+  DenseMap<const TargetSubtargetInfo *, bool> HasScheduleState;
+
 #ifndef NDEBUG
   static int NumTries;
 #endif
@@ -280,6 +293,8 @@ class SwingSchedulerDAG : public ScheduleDAGInstrs {
     SmallVector<SmallVector<int, 4>, 16> AdjK;
     unsigned NumPaths;
     static unsigned MaxPaths;
+    /// Number of calls to circuit() across all the start nodes.
+    unsigned NumSteps = 0;
 
   public:
     Circuits(std::vector<SUnit> &SUs)
@@ -293,6 +308,10 @@ class SwingSchedulerDAG : public ScheduleDAGInstrs {
       NumPaths = 0;
     }
 
+    /// Return true if the search has exceeded its budget, in which case the
+    /// set of circuits found is incomplete.
+    bool isBudgetExhausted() const { return NumSteps > SwpMaxCircuitSteps; }
+
     void createAdjacencyStructure(SwingSchedulerDAG *DAG);
     bool circuit(int V, int S, NodeSetType &NodeSets, bool HasBackedge = false);
     void unblock(int U);
@@ -388,7 +407,7 @@ private:
   void changeDependences();
   unsigned calculateResMII();
   unsigned calculateRecMII(NodeSetType &RecNodeSets);
-  void findCircuits(NodeSetType &NodeSets);
+  bool findCircuits(NodeSetType &NodeSets);
   void fuseRecs(NodeSetType &NodeSets);
   void removeDuplicateNodes(NodeSetType &NodeSets);
   void computeNodeFunctions(NodeSetType &NodeSets);
@@ -751,6 +770,18 @@ bool MachinePipeliner::runOnMachineFunction(MachineFunction &mf) {
   MLI = &getAnalysis<MachineLoopInfo>();
   MDT = &getAnalysis<MachineDominatorTree>();
   TII = MF->getSubtarget().getInstrInfo();
+
+  // Resources are modeled with the target's packetizer DFA, both for the
+  // resource MII and while scheduling. Without one there is nothing to do.
+  const TargetSubtargetInfo &ST = MF->getSubtarget();
+  auto HasDFA = HasScheduleState.insert({&ST, false});
+  if (HasDFA.second)
+    HasDFA.first->second =
+        std::unique_ptr<DFAPacketizer>(TII->CreateTargetScheduleState(ST)) !=
+        nullptr;
+  if (!HasDFA.first->second)
+    return false;
+
   RegClassInfo.runOnMachineFunction(*MF);
 
   for (auto &L : *MLI)
@@ -892,7 +923,12 @@ void SwingSchedulerDAG::schedule() {
   });
 
   NodeSetType NodeSets;
-  findCircuits(NodeSets);
+  // Without all the recurrences the RecMII is unknown, so we can't tell
+  // whether a schedule respects them.
+  if (!findCircuits(NodeSets)) {
+    LLVM_DEBUG(dbgs() << "Recurrence search exceeded its budget\n");
+    return;
+  }
   NodeSetType Circuits = NodeSets;
 
   // Calculate the MII.
@@ -1551,9 +1587,10 @@ bool SwingSchedulerDAG::Circuits::circuit(int V, int S, NodeSetType &NodeSets,
   bool F = false;
   Stack.insert(SV);
   Blocked.set(V);
+  ++NumSteps;
 
   for (auto W : AdjK[V]) {
-    if (NumPaths > MaxPaths)
+    if (NumPaths > MaxPaths || isBudgetExhausted())
       break;
     if (W < S)
       continue;
@@ -1598,8 +1635,9 @@ void SwingSchedulerDAG::Circuits::unblock(int U) {
 }
 
 /// Identify all the elementary circuits in the dependence graph using
-/// Johnson's circuit algorithm.
-void SwingSchedulerDAG::findCircuits(NodeSetType &NodeSets) {
+/// Johnson's circuit algorithm. Return false if the search was abandoned
+/// because it exceeded its budget.
+bool SwingSchedulerDAG::findCircuits(NodeSetType &NodeSets) {
   // Swap all the anti dependences in the DAG. That means it is no longer a DAG,
   // but we do this to find the circuits, and then change them back.
   swapAntiDependences(SUnits);
@@ -1607,13 +1645,14 @@ void SwingSchedulerDAG::findCircuits(NodeSetType &NodeSets) {
   Circuits Cir(SUnits);
   // Create the adjacency structure.
   Cir.createAdjacencyStructure(this);
-  for (int i = 0, e = SUnits.size(); i != e; ++i) {
+  for (int i = 0, e = SUnits.size(); i != e && !Cir.isBudgetExhausted(); ++i) {
     Cir.reset();
     Cir.circuit(i, i, NodeSets);
   }
 
   // Change the dependences back so that we've created a DAG again.
   swapAntiDependences(SUnits);
+  return !Cir.isBudgetExhausted();
 }
 
 /// Return true for DAG nodes that we ignore when computing the cost functions.
@@ -48,15 +48,19 @@ MachineSSAUpdater::MachineSSAUpdater(MachineFunction &MF,
 
 MachineSSAUpdater::~MachineSSAUpdater() {
   delete static_cast<AvailableValsTy*>(AV);
+  delete static_cast<AvailableValsTy*>(MiddleVals);
 }
 
 /// Initialize - Reset this object to get ready for a new set of SSA
 /// updates.  ProtoValue is the value used to name PHI nodes.
 void MachineSSAUpdater::Initialize(unsigned V) {
-  if (!AV)
+  if (!AV) {
     AV = new AvailableValsTy();
-  else
+    MiddleVals = new AvailableValsTy();
+  } else {
     getAvailableVals(AV).clear();
+    getAvailableVals(MiddleVals).clear();
+  }
 
   VR = V;
   VRC = MRI->getRegClass(VR);
@@ -72,6 +76,8 @@ bool MachineSSAUpdater::HasValueForBlock(MachineBasicBlock *BB) const {
 /// specified block with the specified value.
 void MachineSSAUpdater::AddAvailableValue(MachineBasicBlock *BB, unsigned V) {
   getAvailableVals(AV)[BB] = V;
+  // A new definition may change the value reaching any block.
+  getAvailableVals(MiddleVals).clear();
 }
 
 /// GetValueAtEndOfBlock - Construct SSA form, materializing a value that is
@@ -147,6 +153,19 @@ unsigned MachineSSAUpdater::GetValueInMiddleOfBlock(MachineBasicBlock *BB) {
   if (!HasValueForBlock(BB))
     return GetValueAtEndOfBlockInternal(BB);
 
+  // All uses in the middle of BB see the same value; reuse it if it has
+  // already been computed.
+  unsigned &MiddleVal = getAvailableVals(MiddleVals)[BB];
+  if (!MiddleVal)
+    MiddleVal = GetValueInMiddleOfBlockInternal(BB);
+  return MiddleVal;
+}
+
+/// GetValueInMiddleOfBlockInternal - Compute the value live into BB, which
+/// has a value available at its end, by merging the values live out of its
+/// predecessors.
+unsigned
+MachineSSAUpdater::GetValueInMiddleOfBlockInternal(MachineBasicBlock *BB) {
   // If there are no predecessors, just return undef.
   if (BB->pred_empty()) {
     // Insert an implicit_def to represent an undef value.
@@ -231,6 +231,7 @@ void RegPressureTracker::reset() {
 
   CurrSetPressure.clear();
   LiveThruPressure.clear();
+  ExcessLimits.clear();
   P.MaxSetPressure.clear();
 
   if (RequireIntervals)
@@ -270,6 +271,7 @@ void RegPressureTracker::init(const MachineFunction *mf,
   CurrSetPressure.assign(TRI->getNumRegPressureSets(), 0);
 
   P.MaxSetPressure = CurrSetPressure;
+  updateExcessLimits();
 
   LiveRegs.init(*MRI);
   if (TrackUntiedDefs)
@@ -351,6 +353,19 @@ void RegPressureTracker::initLiveThru(const RegPressureTracker &RPTracker) {
       increaseSetPressure(LiveThruPressure, *MRI, RegUnit,
                           LaneBitmask::getNone(), Pair.LaneMask);
   }
+  updateExcessLimits();
+}
+
+/// Recompute the limit beyond which each pressure set is in excess.
+void RegPressureTracker::updateExcessLimits() {
+  unsigned NumSets = TRI->getNumRegPressureSets();
+  ExcessLimits.resize(NumSets);
+  for (unsigned i = 0; i < NumSets; ++i)
+    ExcessLimits[i] = RCI->getRegPressureSetLimit(i);
+  if (LiveThruPressure.empty())
+    return;
+  for (unsigned i = 0; i < NumSets; ++i)
+    ExcessLimits[i] += LiveThruPressure[i];
 }
 
 static LaneBitmask getRegLanes(ArrayRef<RegisterMaskPair> RegUnits,
@@ -938,8 +953,7 @@ void RegPressureTracker::advance() {
 static void computeExcessPressureDelta(ArrayRef<unsigned> OldPressureVec,
                                        ArrayRef<unsigned> NewPressureVec,
                                        RegPressureDelta &Delta,
-                                       const RegisterClassInfo *RCI,
-                                       ArrayRef<unsigned> LiveThruPressureVec) {
+                                       ArrayRef<unsigned> ExcessLimits) {
   Delta.Excess = PressureChange();
   for (unsigned i = 0, e = OldPressureVec.size(); i < e; ++i) {
     unsigned POld = OldPressureVec[i];
@@ -948,9 +962,7 @@ static void computeExcessPressureDelta(ArrayRef<unsigned> OldPressureVec,
     if (!PDiff) // No change in this set in the common case.
       continue;
     // Only consider change beyond the limit.
-    unsigned Limit = RCI->getRegPressureSetLimit(i);
-    if (!LiveThruPressureVec.empty())
-      Limit += LiveThruPressureVec[i];
+    unsigned Limit = ExcessLimits[i];
 
     if (Limit > POld) {
       if (Limit > PNew)
@@ -1074,16 +1086,15 @@ getMaxUpwardPressureDelta(const MachineInstr *MI, PressureDiff *PDiff,
                           RegPressureDelta &Delta,
                           ArrayRef<PressureChange> CriticalPSets,
                           ArrayRef<unsigned> MaxPressureLimit) {
-  // Snapshot Pressure.
-  // FIXME: The snapshot heap space should persist. But I'm planning to
-  // summarize the pressure effect so we don't need to snapshot at all.
-  std::vector<unsigned> SavedPressure = CurrSetPressure;
-  std::vector<unsigned> SavedMaxPressure = P.MaxSetPressure;
+  // Snapshot Pressure. The snapshot vectors keep their capacity across
+  // queries, so this does not allocate.
+  SavedPressure = CurrSetPressure;
+  SavedMaxPressure = P.MaxSetPressure;
 
   bumpUpwardPressure(MI);
 
-  computeExcessPressureDelta(SavedPressure, CurrSetPressure, Delta, RCI,
-                             LiveThruPressure);
+  computeExcessPressureDelta(SavedPressure, CurrSetPressure, Delta,
+                             ExcessLimits);
   computeMaxPressureDelta(SavedMaxPressure, P.MaxSetPressure, CriticalPSets,
                           MaxPressureLimit, Delta);
   assert(Delta.CriticalMax.getUnitInc() >= 0 &&
@@ -1148,9 +1159,7 @@ getUpwardPressureDelta(const MachineInstr *MI, /*const*/ PressureDiff &PDiff,
        PDiffI != PDiffE && PDiffI->isValid(); ++PDiffI) {
 
     unsigned PSetID = PDiffI->getPSet();
-    unsigned Limit = RCI->getRegPressureSetLimit(PSetID);
-    if (!LiveThruPressure.empty())
-      Limit += LiveThruPressure[PSetID];
+    unsigned Limit = ExcessLimits[PSetID];
 
     unsigned POld = CurrSetPressure[PSetID];
     unsigned MOld = P.MaxSetPressure[PSetID];
@@ -1323,13 +1332,13 @@ getMaxDownwardPressureDelta(const MachineInstr *MI, RegPressureDelta &Delta,
                             ArrayRef<PressureChange> CriticalPSets,
                             ArrayRef<unsigned> MaxPressureLimit) {
   // Snapshot Pressure.
-  std::vector<unsigned> SavedPressure = CurrSetPressure;
-  std::vector<unsigned> SavedMaxPressure = P.MaxSetPressure;
+  SavedPressure = CurrSetPressure;
+  SavedMaxPressure = P.MaxSetPressure;
 
   bumpDownwardPressure(MI);
 
-  computeExcessPressureDelta(SavedPressure, CurrSetPressure, Delta, RCI,
-                             LiveThruPressure);
+  computeExcessPressureDelta(SavedPressure, CurrSetPressure, Delta,
+                             ExcessLimits);
   computeMaxPressureDelta(SavedMaxPressure, P.MaxSetPressure, CriticalPSets,
                           MaxPressureLimit, Delta);
   assert(Delta.CriticalMax.getUnitInc() >= 0 &&
@@ -608,7 +608,9 @@ Constant *ConstantInt::getFalse(Type *Ty) {
 ConstantInt *ConstantInt::get(LLVMContext &Context, const APInt &V) {
   // get an existing value or the insertion position
   LLVMContextImpl *pImpl = Context.pImpl;
-  std::unique_ptr<ConstantInt> &Slot = pImpl->IntConstants[V];
+  auto &Shard = pImpl->IntConstants.getShard(V);
+  std::lock_guard<UniquingMutex> Lock(Shard.Mutex);
+  std::unique_ptr<ConstantInt> &Slot = Shard.Map[V];
   if (!Slot) {
     // Get the corresponding integer type for the bit width of the value.
     IntegerType *ITy = IntegerType::get(Context, V.getBitWidth());
@@ -757,7 +759,9 @@ Constant *ConstantFP::getZeroValueForNegation(Type *Ty) {
 ConstantFP* ConstantFP::get(LLVMContext &Context, const APFloat& V) {
   LLVMContextImpl* pImpl = Context.pImpl;
 
-  std::unique_ptr<ConstantFP> &Slot = pImpl->FPConstants[V];
+  auto &Shard = pImpl->FPConstants.getShard(V);
+  std::lock_guard<UniquingMutex> Lock(Shard.Mutex);
+  std::unique_ptr<ConstantFP> &Slot = Shard.Map[V];
 
   if (!Slot) {
     Type *Ty;
@@ -1310,8 +1314,9 @@ ConstantAggregateZero *ConstantAggregateZero::get(Type *Ty) {
   assert((Ty->isStructTy() || Ty->isArrayTy() || Ty->isVectorTy()) &&
          "Cannot create an aggregate zero of non-aggregate type!");
 
-  std::unique_ptr<ConstantAggregateZero> &Entry =
-      Ty->getContext().pImpl->CAZConstants[Ty];
+  LLVMContextImpl *pImpl = Ty->getContext().pImpl;
+  std::lock_guard<UniquingMutex> Lock(pImpl->OperandFreeConstantsMutex);
+  std::unique_ptr<ConstantAggregateZero> &Entry = pImpl->CAZConstants[Ty];
   if (!Entry)
     Entry.reset(new ConstantAggregateZero(Ty));
 
@@ -1320,7 +1325,9 @@ ConstantAggregateZero *ConstantAggregateZero::get(Type *Ty) {
 
 /// Remove the constant from the constant table.
 void ConstantAggregateZero::destroyConstantImpl() {
-  getContext().pImpl->CAZConstants.erase(getType());
+  LLVMContextImpl *pImpl = getContext().pImpl;
+  std::lock_guard<UniquingMutex> Lock(pImpl->OperandFreeConstantsMutex);
+  pImpl->CAZConstants.erase(getType());
 }
 
 /// Remove the constant from the constant table.
@@ -1376,8 +1383,9 @@ const APInt &Constant::getUniqueInteger() const {
 //
 
 ConstantPointerNull *ConstantPointerNull::get(PointerType *Ty) {
-  std::unique_ptr<ConstantPointerNull> &Entry =
-      Ty->getContext().pImpl->CPNConstants[Ty];
+  LLVMContextImpl *pImpl = Ty->getContext().pImpl;
+  std::lock_guard<UniquingMutex> Lock(pImpl->OperandFreeConstantsMutex);
+  std::unique_ptr<ConstantPointerNull> &Entry = pImpl->CPNConstants[Ty];
   if (!Entry)
     Entry.reset(new ConstantPointerNull(Ty));
 
@@ -1386,11 +1394,15 @@ ConstantPointerNull *ConstantPointerNull::get(PointerType *Ty) {
 
 /// Remove the constant from the constant table.
 void ConstantPointerNull::destroyConstantImpl() {
-  getContext().pImpl->CPNConstants.erase(getType());
+  LLVMContextImpl *pImpl = getContext().pImpl;
+  std::lock_guard<UniquingMutex> Lock(pImpl->OperandFreeConstantsMutex);
+  pImpl->CPNConstants.erase(getType());
 }
 
 UndefValue *UndefValue::get(Type *Ty) {
-  std::unique_ptr<UndefValue> &Entry = Ty->getContext().pImpl->UVConstants[Ty];
+  LLVMContextImpl *pImpl = Ty->getContext().pImpl;
+  std::lock_guard<UniquingMutex> Lock(pImpl->OperandFreeConstantsMutex);
+  std::unique_ptr<UndefValue> &Entry = pImpl->UVConstants[Ty];
   if (!Entry)
     Entry.reset(new UndefValue(Ty));
 
@@ -1400,7 +1412,9 @@ UndefValue *UndefValue::get(Type *Ty) {
 /// Remove the constant from the constant table.
 void UndefValue::destroyConstantImpl() {
   // Free the constant and any dangling references to it.
-  getContext().pImpl->UVConstants.erase(getType());
+  LLVMContextImpl *pImpl = getContext().pImpl;
+  std::lock_guard<UniquingMutex> Lock(pImpl->OperandFreeConstantsMutex);
+  pImpl->UVConstants.erase(getType());
 }
 
 BlockAddress *BlockAddress::get(BasicBlock *BB) {
@@ -2427,10 +2441,10 @@ Constant *ConstantDataSequential::getImpl(StringRef Elements, Type *Ty) {
     return ConstantAggregateZero::get(Ty);
 
   // Do a lookup to see if we have already formed one of these.
+  LLVMContextImpl *pImpl = Ty->getContext().pImpl;
+  std::lock_guard<UniquingMutex> Lock(pImpl->OperandFreeConstantsMutex);
   auto &Slot =
-      *Ty->getContext()
-           .pImpl->CDSConstants.insert(std::make_pair(Elements, nullptr))
-           .first;
+      *pImpl->CDSConstants.insert(std::make_pair(Elements, nullptr)).first;
 
   // The bucket can point to a linked list of different CDS's that have the same
   // body but different types.  For example, 0,0,0,1 could be a 4 element array
@@ -2453,8 +2467,9 @@ Constant *ConstantDataSequential::getImpl(StringRef Elements, Type *Ty) {
 
 void ConstantDataSequential::destroyConstantImpl() {
   // Remove the constant from the StringMap.
-  StringMap<ConstantDataSequential*> &CDSConstants =
-    getType()->getContext().pImpl->CDSConstants;
+  LLVMContextImpl *pImpl = getType()->getContext().pImpl;
+  std::lock_guard<UniquingMutex> Lock(pImpl->OperandFreeConstantsMutex);
+  StringMap<ConstantDataSequential*> &CDSConstants = pImpl->CDSConstants;
 
   StringMap<ConstantDataSequential*>::iterator Slot =
     CDSConstants.find(getRawDataValues());
@@ -2468,7 +2483,7 @@ void ConstantDataSequential::destroyConstantImpl() {
     // If there is only one value in the bucket (common case) it must be this
     // entry, and removing the entry should remove the bucket completely.
     assert((*Entry) == this && "Hash mismatch in ConstantDataSequential");
-    getContext().pImpl->CDSConstants.erase(Slot);
+    CDSConstants.erase(Slot);
   } else {
     // Otherwise, there are multiple entries linked off the bucket, unlink the
     // node we care about but keep the bucket around.
@@ -18,6 +18,7 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
+#include "llvm/IR/Constants.h"
 #include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/DiagnosticPrinter.h"
 #include "llvm/IR/Metadata.h"
@@ -95,6 +96,12 @@ LLVMContext::LLVMContext() : pImpl(new LLVMContextImpl(*this)) {
   assert(SystemSSID == SyncScope::System &&
          "system synchronization scope ID drifted!");
   (void)SystemSSID;
+
+#if LLVM_ENABLE_THREADSAFE_LEAF_UNIQUING
+  // These are otherwise cached on first use, which would race.
+  ConstantInt::getTrue(*this);
+  ConstantInt::getFalse(*this);
+#endif
 }
 
 LLVMContext::~LLVMContext() { delete pImpl; }
@@ -33,6 +33,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/BinaryFormat/Dwarf.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DebugInfoMetadata.h"
 #include "llvm/IR/DerivedTypes.h"
@@ -47,6 +48,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -94,6 +96,63 @@ struct DenseMapAPFloatKeyInfo {
   }
 };
 
+/// Lock for one of the uniquing tables in LLVMContextImpl. With
+/// LLVM_ENABLE_THREADSAFE_LEAF_UNIQUING it is a real mutex, so that entities
+/// without operands (ConstantInt, ConstantFP, ConstantAggregateZero,
+/// ConstantPointerNull, UndefValue and ConstantDataSequential constants,
+/// types, metadata strings and attributes) can be created from several
+/// threads at once. The tables for constant expressions, other aggregate
+/// constants and MDNodes are not locked. Otherwise a context is only ever
+/// used from one thread at a time and locking does nothing.
+#if LLVM_ENABLE_THREADSAFE_LEAF_UNIQUING
+using UniquingMutex = std::mutex;
+using RecursiveUniquingMutex = std::recursive_mutex;
+#else
+struct UniquingMutex {
+  void lock() {}
+  void unlock() {}
+};
+using RecursiveUniquingMutex = UniquingMutex;
+#endif
+
+/// A uniquing table split into shards that are locked independently, so that
+/// threads creating different entries rarely contend. Without
+/// LLVM_ENABLE_THREADSAFE_LEAF_UNIQUING there is a single shard.
+template <typename MapT, typename KeyInfoT> class ShardedUniquingMap {
+public:
+  struct Shard {
+    UniquingMutex Mutex;
+    MapT Map;
+  };
+
+private:
+#if LLVM_ENABLE_THREADSAFE_LEAF_UNIQUING
+  static constexpr unsigned ShardBits = 4;
+  Shard Shards[1 << ShardBits];
+#else
+  Shard Shards[1];
+#endif
+
+public:
+  /// Returns the shard that holds \p Key. The shard is picked from the top
+  /// bits of a mix of the hash, since the table within a shard indexes by
+  /// the bottom bits.
+  template <typename KeyT> Shard &getShard(const KeyT &Key) {
+#if LLVM_ENABLE_THREADSAFE_LEAF_UNIQUING
+    uint32_t Hash = KeyInfoT::getHashValue(Key) * 0x9E3779B9u;
+    return Shards[Hash >> (32 - ShardBits)];
+#else
+    (void)Key;
+    return Shards[0];
+#endif
+  }
+
+  void clear() {
+    for (Shard &S : Shards)
+      S.Map.clear();
+  }
+};
+
 struct AnonStructTypeKeyInfo {
   struct KeyTy {
     ArrayRef<Type*> ETypes;
@@ -1234,17 +1293,20 @@ public:
 
   using IntMapTy =
       DenseMap<APInt, std::unique_ptr<ConstantInt>, DenseMapAPIntKeyInfo>;
-  IntMapTy IntConstants;
+  ShardedUniquingMap<IntMapTy, DenseMapAPIntKeyInfo> IntConstants;
 
   using FPMapTy =
       DenseMap<APFloat, std::unique_ptr<ConstantFP>, DenseMapAPFloatKeyInfo>;
-  FPMapTy FPConstants;
+  ShardedUniquingMap<FPMapTy, DenseMapAPFloatKeyInfo> FPConstants;
 
+  /// Guards the three attribute uniquing sets.
+  UniquingMutex AttrsMutex;
   FoldingSet<AttributeImpl> AttrsSet;
   FoldingSet<AttributeListImpl> AttrsLists;
   FoldingSet<AttributeSetNode> AttrsSetNodes;
 
-  StringMap<MDString, BumpPtrAllocator> MDStringCache;
+  using MDStringMapTy = StringMap<MDString, BumpPtrAllocator>;
+  ShardedUniquingMap<MDStringMapTy, DenseMapInfo<StringRef>> MDStringCache;
   DenseMap<Value *, ValueAsMetadata *> ValuesAsMetadata;
   DenseMap<Metadata *, MetadataAsValue *> MetadataAsValues;
 
@@ -1263,6 +1325,8 @@ public:
   // them on context teardown.
   std::vector<MDNode *> DistinctMDNodes;
 
+  /// Guards CAZConstants, CPNConstants, UVConstants and CDSConstants.
+  UniquingMutex OperandFreeConstantsMutex;
   DenseMap<Type *, std::unique_ptr<ConstantAggregateZero>> CAZConstants;
 
   using ArrayConstantsTy = ConstantUniqueMap<ConstantArray>;
@@ -1296,6 +1360,10 @@ public:
   Type X86_FP80Ty, FP128Ty, PPC_FP128Ty, X86_MMXTy;
   IntegerType Int1Ty, Int8Ty, Int16Ty, Int32Ty, Int64Ty, Int128Ty;
 
+  /// Guards TypeAllocator and the type tables below. It is recursive because
+  /// creating a literal or named struct type sets its body or name.
+  RecursiveUniquingMutex TypeMutex;
+
   /// TypeAllocator - All dynamically allocated types are allocated from this.
   /// They live forever until the context is torn down.
   BumpPtrAllocator TypeAllocator;
@@ -1619,6 +1619,7 @@ bool FPPassManager::runOnFunction(Function &F) {
   unsigned InstrCount, FunctionSize = 0;
   StringMap<std::pair<unsigned, unsigned>> FunctionToInstrCount;
   bool EmitICRemark = M.shouldEmitInstrCountChangedRemark();
+  FunctionPassTimingReport *TimingReport = FunctionPassTimingReport::get();
   // Collect the initial size of the module.
   if (EmitICRemark) {
     InstrCount = initSizeRemarkInfo(M, FunctionToInstrCount);
@@ -1637,7 +1638,11 @@ bool FPPassManager::runOnFunction(Function &F) {
     {
       PassManagerPrettyStackEntry X(FP, F);
       TimeRegion PassTimer(getPassTimer(FP));
+      if (TimingReport)
+        TimingReport->startPass(FP, F);
       LocalChanged |= FP->runOnFunction(F);
+      if (TimingReport)
+        TimingReport->stopPass(F);
       if (EmitICRemark) {
         unsigned NewSize = F.getInstructionCount();
 
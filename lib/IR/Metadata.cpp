@@ -452,7 +452,9 @@ void ValueAsMetadata::handleRAUW(Value *From, Value *To) {
 //
 
 MDString *MDString::get(LLVMContext &Context, StringRef Str) {
-  auto &Store = Context.pImpl->MDStringCache;
+  auto &Shard = Context.pImpl->MDStringCache.getShard(Str);
+  std::lock_guard<UniquingMutex> Lock(Shard.Mutex);
+  auto &Store = Shard.Map;
   auto I = Store.try_emplace(Str);
   auto &MapEntry = I.first->getValue();
   if (!I.second)
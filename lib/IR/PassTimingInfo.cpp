@@ -20,12 +20,16 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/IR/Function.h"
 #include "llvm/Pass.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/Mutex.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <string>
@@ -42,6 +46,11 @@ static cl::opt<bool, true> EnableTiming(
     "time-passes", cl::location(TimePassesIsEnabled), cl::Hidden,
     cl::desc("Time each pass, printing elapsed time for each on exit"));
 
+static cl::opt<std::string> TimePassesPerFunction(
+    "time-passes-per-function", cl::Hidden, cl::value_desc("filename"),
+    cl::desc("Time each function pass on each function, writing a JSON "
+             "report to the given file on exit"));
+
 namespace {
 static ManagedStatic<sys::SmartMutex<true>> TimingInfoMutex;
 }
@@ -138,6 +147,107 @@ Timer *getPassTimer(StringRef PassName) {
   return nullptr;
 }
 
+//===----------------------------------------------------------------------===//
+// FunctionPassTimingReport implementation
+
+/// Uses the pass argument as the pass identifier where there is one, like the
+/// -time-passes timers do.
+static StringRef getPassID(Pass *P) {
+  if (const PassInfo *PI = Pass::lookupPassInfo(P->getPassID()))
+    if (!PI->getPassArgument().empty())
+      return PI->getPassArgument();
+  return P->getPassName();
+}
+
+FunctionPassTimingReport *FunctionPassTimingReport::get() {
+  if (TimePassesPerFunction.empty())
+    return nullptr;
+  static ManagedStatic<FunctionPassTimingReport> Report;
+  return &*Report;
+}
+
+FunctionPassTimingReport::~FunctionPassTimingReport() {
+  std::error_code EC;
+  raw_fd_ostream OS(TimePassesPerFunction, EC, sys::fs::F_Text);
+  if (EC) {
+    errs() << "error: could not open per-function timing report file '"
+           << TimePassesPerFunction << "': " << EC.message() << '\n';
+    return;
+  }
+  print(OS);
+}
+
+void FunctionPassTimingReport::startPass(Pass *P, Function &F) {
+  assert(!InPass && "function passes do not nest");
+  InPass = true;
+  Current.PassID = getPassID(P);
+  Current.InstrsBefore = F.getInstructionCount();
+  Current.HasMachineInstrs = false;
+  StartMalloc = sys::Process::GetMallocUsage();
+  StartTime = TimeRecord::getCurrentTime(/*Start=*/true);
+}
+
+void FunctionPassTimingReport::setMachineInstrCounts(unsigned Before,
+                                                     unsigned After) {
+  if (!InPass)
+    return;
+  Current.HasMachineInstrs = true;
+  Current.MachineInstrsBefore = Before;
+  Current.MachineInstrsAfter = After;
+}
+
+void FunctionPassTimingReport::stopPass(Function &F) {
+  assert(InPass && "stopPass without startPass");
+  TimeRecord Elapsed = TimeRecord::getCurrentTime(/*Start=*/false);
+  Elapsed -= StartTime;
+  InPass = false;
+
+  Current.WallTime = Elapsed.getWallTime();
+  Current.UserTime = Elapsed.getUserTime();
+  Current.MallocBytes = static_cast<int64_t>(sys::Process::GetMallocUsage()) -
+                        static_cast<int64_t>(StartMalloc);
+  Current.InstrsAfter = F.getInstructionCount();
+
+  auto Inserted = FunctionIndex.try_emplace(F.getName(), Functions.size());
+  if (Inserted.second) {
+    Functions.emplace_back();
+    // IR names are arbitrary bytes but JSON strings must be valid UTF-8.
+    StringRef Name = F.getName();
+    Functions.back().Name =
+        json::isUTF8(Name) ? Name.str() : json::fixUTF8(Name);
+  }
+  Functions[Inserted.first->second].Passes.push_back(std::move(Current));
+}
+
+void FunctionPassTimingReport::print(raw_ostream &OS) const {
+  json::Array JSONFunctions;
+  for (const FunctionRecord &FR : Functions) {
+    double TotalWallTime = 0;
+    json::Array JSONPasses;
+    for (const PassRecord &PR : FR.Passes) {
+      TotalWallTime += PR.WallTime;
+      json::Object JSONPass{{"pass", PR.PassID},
+                            {"wall_time", PR.WallTime},
+                            {"user_time", PR.UserTime},
+                            {"malloc_bytes", PR.MallocBytes},
+                            {"instrs_before", int64_t(PR.InstrsBefore)},
+                            {"instrs_after", int64_t(PR.InstrsAfter)}};
+      if (PR.HasMachineInstrs) {
+        JSONPass["machine_instrs_before"] = int64_t(PR.MachineInstrsBefore);
+        JSONPass["machine_instrs_after"] = int64_t(PR.MachineInstrsAfter);
+      }
+      JSONPasses.push_back(std::move(JSONPass));
+    }
+    JSONFunctions.push_back(json::Object{{"name", FR.Name},
+                                         {"wall_time", TotalWallTime},
+                                         {"passes", std::move(JSONPasses)}});
+  }
+  OS << formatv("{0:2}",
+                json::Value(json::Object{
+                    {"functions", std::move(JSONFunctions)}}))
+     << '\n';
+}
+
 /// If timing is enabled, report the times collected up to now and then reset
 /// them.
 void reportAndResetTimings() {
@@ -39,6 +39,7 @@
 #include "llvm/MC/StringTableBuilder.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Error.h"
@@ -46,6 +47,7 @@
 #include "llvm/Support/Host.h"
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SMLoc.h"
 #include "llvm/Support/StringSaver.h"
 #include "llvm/Support/SwapByteOrder.h"
@@ -65,6 +67,10 @@ using namespace llvm;
 #undef  DEBUG_TYPE
 #define DEBUG_TYPE "reloc-info"
 
+static cl::opt<bool> ParallelCompressDebugSections(
+    "elf-parallel-compress-debug-sections", cl::Hidden, cl::init(true),
+    cl::desc("Compress debug sections concurrently when writing ELF objects"));
+
 namespace {
 
 using SectionIndexMapTy = DenseMap<const MCSectionELF *, uint32_t>;
@@ -162,6 +168,23 @@ struct ELFWriter {
                              SmallVectorImpl<char> &CompressedContents,
                              bool ZLibStyle, unsigned Alignment);
 
+  bool isCompressionProfitable(uint64_t Size, uint64_t CompressedSize,
+                               bool ZLibStyle) const;
+
+  /// A debug section compressed ahead of time by compressDebugSections and
+  /// written out in the usual order by writeSectionData. Only the bytes that
+  /// will be written are kept: Compressed if compressing the section pays
+  /// off, Uncompressed otherwise.
+  struct CompressedSectionData {
+    SmallVector<char, 0> Uncompressed;
+    SmallVector<char, 0> Compressed;
+    uint64_t UncompressedSize = 0;
+  };
+  std::vector<CompressedSectionData> CompressedSections;
+  DenseMap<const MCSectionELF *, unsigned> CompressedSectionIndex;
+
+  bool isWrittenInThisMode(const MCSectionELF &Sec) const;
+
 public:
   ELFWriter(ELFObjectWriter &OWriter, raw_pwrite_stream &OS,
             bool IsLittleEndian, DwoMode Mode)
@@ -212,6 +235,7 @@ public:
                           const SectionIndexMapTy &SectionIndexMap,
                           const SectionOffsetsTy &SectionOffsets);
 
+  void compressDebugSections(const MCAssembler &Asm, const MCAsmLayout &Layout);
   void writeSectionData(const MCAssembler &Asm, MCSection &Sec,
                         const MCAsmLayout &Layout);
 
@@ -790,15 +814,27 @@ MCSectionELF *ELFWriter::createRelocationSection(MCContext &Ctx,
   return RelaSection;
 }
 
+// Whether the compressed section, including its header, is smaller than the
+// uncompressed one.
+bool ELFWriter::isCompressionProfitable(uint64_t Size, uint64_t CompressedSize,
+                                        bool ZLibStyle) const {
+  if (ZLibStyle) {
+    uint64_t HdrSize =
+        is64Bit() ? sizeof(ELF::Elf32_Chdr) : sizeof(ELF::Elf64_Chdr);
+    return Size > HdrSize + CompressedSize;
+  }
+  // "ZLIB" followed by 8 bytes representing the uncompressed size of the
+  // section.
+  return Size > StringRef("ZLIB").size() + sizeof(Size) + CompressedSize;
+}
+
 // Include the debug info compression header.
 bool ELFWriter::maybeWriteCompression(
     uint64_t Size, SmallVectorImpl<char> &CompressedContents, bool ZLibStyle,
     unsigned Alignment) {
+  if (!isCompressionProfitable(Size, CompressedContents.size(), ZLibStyle))
+    return false;
   if (ZLibStyle) {
-    uint64_t HdrSize =
-        is64Bit() ? sizeof(ELF::Elf32_Chdr) : sizeof(ELF::Elf64_Chdr);
-    if (Size <= HdrSize + CompressedContents.size())
-      return false;
     // Platform specific header is followed by compressed data.
     if (is64Bit()) {
       // Write Elf64_Chdr header.
@@ -818,13 +854,84 @@ bool ELFWriter::maybeWriteCompression(
   // "ZLIB" followed by 8 bytes representing the uncompressed size of the section,
   // useful for consumers to preallocate a buffer to decompress into.
   const StringRef Magic = "ZLIB";
-  if (Size <= Magic.size() + sizeof(Size) + CompressedContents.size())
-    return false;
   W.OS << Magic;
   support::endian::write(W.OS, Size, support::big);
   return true;
 }
 
+// Compressing debug_frame requires handling alignment fragments which is
+// more work (possibly generalizing MCAssembler.cpp:writeFragment to allow
+// for writing to arbitrary buffers) for little benefit.
+static bool shouldCompressSection(const MCAsmInfo &MAI,
+                                  const MCSectionELF &Section) {
+  StringRef SectionName = Section.getSectionName();
+  return MAI.compressDebugSections() != DebugCompressionType::None &&
+         SectionName.startswith(".debug_") && SectionName != ".debug_frame";
+}
+
+bool ELFWriter::isWrittenInThisMode(const MCSectionELF &Sec) const {
+  if (Mode == NonDwoOnly && isDwoSection(Sec))
+    return false;
+  if (Mode == DwoOnly && !isDwoSection(Sec))
+    return false;
+  return true;
+}
+
+// Render and compress every debug section that writeSectionData will emit
+// compressed, so that zlib can run on the sections concurrently. Rendering
+// touches the assembler and stays serial. Each section keeps only the bytes
+// it will be written with, so the uncompressed copy of a section is released
+// as soon as its compressed copy is known to be used instead. The results are
+// consumed in section order, so the output does not depend on how the work
+// was scheduled. When compressing serially this does nothing, and
+// writeSectionData renders and compresses one section at a time.
+void ELFWriter::compressDebugSections(const MCAssembler &Asm,
+                                      const MCAsmLayout &Layout) {
+  const MCAsmInfo &MAI = *Asm.getContext().getAsmInfo();
+  if (MAI.compressDebugSections() == DebugCompressionType::None ||
+      !ParallelCompressDebugSections)
+    return;
+
+  assert((MAI.compressDebugSections() == DebugCompressionType::Z ||
+          MAI.compressDebugSections() == DebugCompressionType::GNU) &&
+         "expected zlib or zlib-gnu style compression");
+
+  std::vector<const MCSectionELF *> Sections;
+  for (const MCSection &Sec : Asm) {
+    const MCSectionELF &Section = static_cast<const MCSectionELF &>(Sec);
+    if (isWrittenInThisMode(Section) && shouldCompressSection(MAI, Section))
+      Sections.push_back(&Section);
+  }
+  if (Sections.size() < 2)
+    return;
+
+  CompressedSections.resize(Sections.size());
+  for (size_t I = 0, E = Sections.size(); I != E; ++I) {
+    CompressedSectionIndex[Sections[I]] = I;
+    raw_svector_ostream VecOS(CompressedSections[I].Uncompressed);
+    Asm.writeSectionData(VecOS, Sections[I], Layout);
+  }
+
+  bool ZlibStyle = MAI.compressDebugSections() == DebugCompressionType::Z;
+  parallel::for_each_n(
+      parallel::par, size_t(0), CompressedSections.size(), [&](size_t I) {
+        CompressedSectionData &Data = CompressedSections[I];
+        Data.UncompressedSize = Data.Uncompressed.size();
+        if (Error E = zlib::compress(
+                StringRef(Data.Uncompressed.data(), Data.Uncompressed.size()),
+                Data.Compressed)) {
+          consumeError(std::move(E));
+          SmallVector<char, 0>().swap(Data.Compressed);
+          return;
+        }
+        if (isCompressionProfitable(Data.UncompressedSize,
+                                    Data.Compressed.size(), ZlibStyle))
+          SmallVector<char, 0>().swap(Data.Uncompressed);
+        else
+          SmallVector<char, 0>().swap(Data.Compressed);
+      });
+}
+
 void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
                                  const MCAsmLayout &Layout) {
   MCSectionELF &Section = static_cast<MCSectionELF &>(Sec);
@@ -833,13 +940,7 @@ void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
   auto &MC = Asm.getContext();
   const auto &MAI = MC.getAsmInfo();
 
-  // Compressing debug_frame requires handling alignment fragments which is
-  // more work (possibly generalizing MCAssembler.cpp:writeFragment to allow
-  // for writing to arbitrary buffers) for little benefit.
-  bool CompressionEnabled =
-      MAI->compressDebugSections() != DebugCompressionType::None;
-  if (!CompressionEnabled || !SectionName.startswith(".debug_") ||
-      SectionName == ".debug_frame") {
+  if (!shouldCompressSection(*MAI, Section)) {
     Asm.writeSectionData(W.OS, &Section, Layout);
     return;
   }
@@ -848,22 +949,39 @@ void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
           MAI->compressDebugSections() == DebugCompressionType::GNU) &&
          "expected zlib or zlib-gnu style compression");
 
+  uint64_t UncompressedSize;
   SmallVector<char, 128> UncompressedData;
-  raw_svector_ostream VecOS(UncompressedData);
-  Asm.writeSectionData(VecOS, &Section, Layout);
-
-  SmallVector<char, 128> CompressedContents;
-  if (Error E = zlib::compress(
-          StringRef(UncompressedData.data(), UncompressedData.size()),
-          CompressedContents)) {
-    consumeError(std::move(E));
-    W.OS << UncompressedData;
-    return;
+  SmallVector<char, 128> CompressedData;
+  SmallVectorImpl<char> *Compressed = &CompressedData;
+
+  auto It = CompressedSectionIndex.find(&Section);
+  if (It != CompressedSectionIndex.end()) {
+    // Compressed ahead of time; an empty Uncompressed means the compressed
+    // copy is used.
+    CompressedSectionData &Data = CompressedSections[It->second];
+    if (!Data.Uncompressed.empty() || Data.UncompressedSize == 0) {
+      W.OS << Data.Uncompressed;
+      return;
+    }
+    UncompressedSize = Data.UncompressedSize;
+    Compressed = &Data.Compressed;
+  } else {
+    raw_svector_ostream VecOS(UncompressedData);
+    Asm.writeSectionData(VecOS, &Section, Layout);
+    UncompressedSize = UncompressedData.size();
+
+    if (Error E = zlib::compress(
+            StringRef(UncompressedData.data(), UncompressedData.size()),
+            CompressedData)) {
+      consumeError(std::move(E));
+      W.OS << UncompressedData;
+      return;
+    }
   }
 
   bool ZlibStyle = MAI->compressDebugSections() == DebugCompressionType::Z;
-  if (!maybeWriteCompression(UncompressedData.size(), CompressedContents,
-                             ZlibStyle, Sec.getAlignment())) {
+  if (!maybeWriteCompression(UncompressedSize, *Compressed, ZlibStyle,
+                             Sec.getAlignment())) {
     W.OS << UncompressedData;
     return;
   }
@@ -874,7 +992,7 @@ void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
   else
     // Add "z" prefix to section name. This is zlib-gnu style.
     MC.renameELFSection(&Section, (".z" + SectionName.drop_front(1)).str());
-  W.OS << CompressedContents;
+  W.OS << *Compressed;
 }
 
 void ELFWriter::WriteSecHdrEntry(uint32_t Name, uint32_t Type, uint64_t Flags,
@@ -1067,11 +1185,10 @@ uint64_t ELFWriter::writeObject(MCAssembler &Asm, const MCAsmLayout &Layout) {
   SectionOffsetsTy SectionOffsets;
   std::vector<MCSectionELF *> Groups;
   std::vector<MCSectionELF *> Relocations;
+  compressDebugSections(Asm, Layout);
   for (MCSection &Sec : Asm) {
     MCSectionELF &Section = static_cast<MCSectionELF &>(Sec);
-    if (Mode == NonDwoOnly && isDwoSection(Section))
-      continue;
-    if (Mode == DwoOnly && !isDwoSection(Section))
+    if (!isWrittenInThisMode(Section))
       continue;
 
     align(Section.getAlignment());
@@ -37,6 +37,7 @@
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cstring>
@@ -68,6 +69,8 @@ STATISTIC(FragmentLayouts, "Number of fragment layouts");
 STATISTIC(ObjectBytes, "Number of emitted object file bytes");
 STATISTIC(RelaxationSteps, "Number of assembler layout and relaxation steps");
 STATISTIC(RelaxedInstructions, "Number of relaxed instructions");
+STATISTIC(SkippedRelaxationChecks,
+          "Number of relaxable instructions not re-examined during layout");
 STATISTIC(PaddingFragmentsRelaxations,
           "Number of Padding Fragments relaxations");
 STATISTIC(PaddingFragmentsBytes,
@@ -1023,7 +1026,54 @@ bool MCAssembler::relaxCVDefRange(MCAsmLayout &Layout,
   return OldSize != F.getContents().size();
 }
 
-bool MCAssembler::layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec) {
+/// Compute in \p LastOrder the highest layout order of a fragment defining a
+/// symbol referenced by \p Expr. Return false if \p Expr refers to anything
+/// other than labels in \p Sec, in which case its value may depend on the
+/// layout of the whole section, or of other sections.
+static bool getLastReferencedOrder(const MCExpr &Expr, const MCSection &Sec,
+                                   unsigned &LastOrder) {
+  switch (Expr.getKind()) {
+  case MCExpr::Constant:
+    return true;
+  case MCExpr::SymbolRef: {
+    const MCSymbol &Sym = cast<MCSymbolRefExpr>(Expr).getSymbol();
+    if (Sym.isVariable())
+      return false;
+    const MCFragment *Frag = Sym.getFragment();
+    if (!Frag || Sym.isAbsolute() || Frag->getParent() != &Sec)
+      return false;
+    LastOrder = std::max(LastOrder, Frag->getLayoutOrder());
+    return true;
+  }
+  case MCExpr::Unary:
+    return getLastReferencedOrder(*cast<MCUnaryExpr>(Expr).getSubExpr(), Sec,
+                                  LastOrder);
+  case MCExpr::Binary: {
+    const MCBinaryExpr &BE = cast<MCBinaryExpr>(Expr);
+    return getLastReferencedOrder(*BE.getLHS(), Sec, LastOrder) &&
+           getLastReferencedOrder(*BE.getRHS(), Sec, LastOrder);
+  }
+  case MCExpr::Target:
+    return false;
+  }
+  llvm_unreachable("Invalid assembly expression kind!");
+}
+
+/// Return true if relaxing \p Changed may change whether \p F needs
+/// relaxation. Fragment offsets only depend on the sizes of the fragments
+/// before them, so this can only happen if \p F, or a label one of its fixups
+/// refers to, is laid out after \p Changed.
+static bool mayObserveRelaxation(const MCRelaxableFragment &F,
+                                 const MCFragment &Changed) {
+  unsigned LastOrder = F.getLayoutOrder();
+  for (const MCFixup &Fixup : F.getFixups())
+    if (!getLastReferencedOrder(*Fixup.getValue(), *F.getParent(), LastOrder))
+      return true;
+  return LastOrder >= Changed.getLayoutOrder();
+}
+
+MCFragment *MCAssembler::layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec,
+                                           const MCFragment *FirstChanged) {
   // Holds the first fragment which needed relaxing during this layout. It will
   // remain NULL if none were relaxed.
   // When a fragment is relaxed, all the fragments following it should get
@@ -1037,11 +1087,19 @@ bool MCAssembler::layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec) {
     switch(I->getKind()) {
     default:
       break;
-    case MCFragment::FT_Relaxable:
+    case MCFragment::FT_Relaxable: {
       assert(!getRelaxAll() &&
              "Did not expect a MCRelaxableFragment in RelaxAll mode");
-      RelaxedFrag = relaxInstruction(Layout, *cast<MCRelaxableFragment>(I));
+      auto &RF = *cast<MCRelaxableFragment>(I);
+      // Skip instructions which cannot see the offsets changed by the last
+      // iteration; they still fit.
+      if (FirstChanged && !mayObserveRelaxation(RF, *FirstChanged)) {
+        ++stats::SkippedRelaxationChecks;
+        break;
+      }
+      RelaxedFrag = relaxInstruction(Layout, RF);
       break;
+    }
     case MCFragment::FT_Dwarf:
       RelaxedFrag = relaxDwarfLineAddr(Layout,
                                        *cast<MCDwarfLineAddrFragment>(I));
@@ -1068,11 +1126,9 @@ bool MCAssembler::layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec) {
     if (RelaxedFrag && !FirstRelaxedFragment)
       FirstRelaxedFragment = &*I;
   }
-  if (FirstRelaxedFragment) {
+  if (FirstRelaxedFragment)
     Layout.invalidateFragmentsFrom(FirstRelaxedFragment);
-    return true;
-  }
-  return false;
+  return FirstRelaxedFragment;
 }
 
 bool MCAssembler::layoutOnce(MCAsmLayout &Layout) {
@@ -1081,8 +1137,15 @@ bool MCAssembler::layoutOnce(MCAsmLayout &Layout) {
   bool WasRelaxed = false;
   for (iterator it = begin(), ie = end(); it != ie; ++it) {
     MCSection &Sec = *it;
-    while (layoutSectionOnce(Layout, Sec))
+    // The first iteration examines every fragment. Later ones only need to
+    // look at the fragments which may be affected by the previous one, but
+    // still walk all the fragments of the section to find them: a fragment
+    // before the one relaxed may branch past it.
+    const MCFragment *FirstChanged = nullptr;
+    while (MCFragment *Relaxed = layoutSectionOnce(Layout, Sec, FirstChanged)) {
+      FirstChanged = Relaxed;
       WasRelaxed = true;
+    }
   }
 
   return WasRelaxed;
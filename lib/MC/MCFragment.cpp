@@ -233,6 +233,21 @@ uint64_t llvm::computeBundlePadding(const MCAssembler &Assembler,
 
 void ilist_alloc_traits<MCFragment>::deleteNode(MCFragment *V) { V->destroy(); }
 
+// A fragment is a list node, its section, atom and offset, and a word holding
+// its kind, flags, bundle padding and layout order. Large object files are
+// made of millions of fragments, so add asserts to prevent people from
+// accidentally growing them.
+static_assert(sizeof(MCFragment) == 4 * sizeof(void *) + 4 + sizeof(unsigned) +
+                                        sizeof(uint64_t),
+              "unexpected MCFragment size growth");
+
+// MCEncodedFragment only adds the subtarget; its bundling fields live in
+// MCFragment.
+static_assert(sizeof(MCEncodedFragment) ==
+                  (sizeof(MCFragment) + sizeof(void *) + alignof(MCFragment) -
+                   1) / alignof(MCFragment) * alignof(MCFragment),
+              "unexpected MCEncodedFragment size growth");
+
 MCFragment::~MCFragment() = default;
 
 MCFragment::MCFragment(FragmentType Kind, bool HasInstructions,
@@ -147,6 +147,25 @@ MCObjectStreamer::getOrCreateDataFragment(const MCSubtargetInfo *STI) {
   return F;
 }
 
+size_t MCObjectStreamer::encodeInstToDataFragment(MCDataFragment &DF,
+                                                  const MCInst &Inst,
+                                                  const MCSubtargetInfo &STI) {
+  SmallVectorImpl<char> &Contents = DF.getContents();
+  SmallVectorImpl<MCFixup> &Fixups = DF.getFixups();
+  size_t CodeOffset = Contents.size();
+  size_t FirstFixup = Fixups.size();
+
+  // Code emitters record fixup offsets relative to the start of the
+  // instruction, so the encoding can go straight into the fragment.
+  raw_svector_ostream VecOS(Contents);
+  getAssembler().getEmitter().encodeInstruction(Inst, VecOS, Fixups, STI);
+  for (size_t i = FirstFixup, e = Fixups.size(); i != e; ++i)
+    Fixups[i].setOffset(Fixups[i].getOffset() + CodeOffset);
+
+  DF.setHasInstructions(STI);
+  return FirstFixup;
+}
+
 MCPaddingFragment *MCObjectStreamer::getOrCreatePaddingFragment() {
   MCPaddingFragment *F =
       dyn_cast_or_null<MCPaddingFragment>(getCurrentFragment());
@@ -347,11 +366,9 @@ void MCObjectStreamer::EmitInstToFragment(const MCInst &Inst,
   MCRelaxableFragment *IF = new MCRelaxableFragment(Inst, STI);
   insert(IF);
 
-  SmallString<128> Code;
-  raw_svector_ostream VecOS(Code);
+  raw_svector_ostream VecOS(IF->getContents());
   getAssembler().getEmitter().encodeInstruction(Inst, VecOS, IF->getFixups(),
                                                 STI);
-  IF->getContents().append(Code.begin(), Code.end());
 }
 
 #ifndef NDEBUG
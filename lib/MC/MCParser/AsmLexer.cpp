@@ -31,8 +31,15 @@
 
 using namespace llvm;
 
-AsmLexer::AsmLexer(const MCAsmInfo &MAI) : MAI(MAI) {
-  AllowAtInIdentifier = !StringRef(MAI.getCommentString()).startswith("@");
+AsmLexer::AsmLexer(const MCAsmInfo &MAI)
+    : MAI(MAI), CommentString(MAI.getCommentString()),
+      SeparatorString(MAI.getSeparatorString()) {
+  AllowAtInIdentifier = !CommentString.startswith("@");
+
+  // LexIdentifier: [a-zA-Z_.][a-zA-Z0-9_$.@?]*
+  for (unsigned C = 0; C != 256; ++C)
+    IdentifierChars[C] = isAlnum(C) || C == '_' || C == '$' || C == '.' ||
+                         C == '?';
 }
 
 AsmLexer::~AsmLexer() = default;
@@ -135,11 +142,6 @@ AsmToken AsmLexer::LexHexFloatLiteral(bool NoIntDigits) {
 }
 
 /// LexIdentifier: [a-zA-Z_.][a-zA-Z0-9_$.@?]*
-static bool IsIdentifierChar(char c, bool AllowAt) {
-  return isAlnum(c) || c == '_' || c == '$' || c == '.' ||
-         (c == '@' && AllowAt) || c == '?';
-}
-
 AsmToken AsmLexer::LexIdentifier() {
   // Check for floating point literals.
   if (CurPtr[-1] == '.' && isDigit(*CurPtr)) {
@@ -147,11 +149,11 @@ AsmToken AsmLexer::LexIdentifier() {
     while (isDigit(*CurPtr))
       ++CurPtr;
     if (*CurPtr == 'e' || *CurPtr == 'E' ||
-        !IsIdentifierChar(*CurPtr, AllowAtInIdentifier))
+        !isIdentifierChar(*CurPtr))
       return LexFloatLiteral();
   }
 
-  while (IsIdentifierChar(*CurPtr, AllowAtInIdentifier))
+  while (isIdentifierChar(*CurPtr))
     ++CurPtr;
 
   // Handle . as a special case.
@@ -525,8 +527,6 @@ size_t AsmLexer::peekTokens(MutableArrayRef<AsmToken> Buf,
 }
 
 bool AsmLexer::isAtStartOfComment(const char *Ptr) {
-  StringRef CommentString = MAI.getCommentString();
-
   if (CommentString.size() == 1)
     return CommentString[0] == Ptr[0];
 
@@ -538,8 +538,9 @@ bool AsmLexer::isAtStartOfComment(const char *Ptr) {
 }
 
 bool AsmLexer::isAtStatementSeparator(const char *Ptr) {
-  return strncmp(Ptr, MAI.getSeparatorString(),
-                 strlen(MAI.getSeparatorString())) == 0;
+  // Check the first character inline; most tokens fail right there.
+  return !SeparatorString.empty() && Ptr[0] == SeparatorString[0] &&
+         strncmp(Ptr, SeparatorString.data(), SeparatorString.size()) == 0;
 }
 
 AsmToken AsmLexer::LexToken() {
@@ -569,11 +570,11 @@ AsmToken AsmLexer::LexToken() {
     return LexLineComment();
 
   if (isAtStatementSeparator(TokStart)) {
-    CurPtr += strlen(MAI.getSeparatorString()) - 1;
+    CurPtr += SeparatorString.size() - 1;
     IsAtStartOfLine = true;
     IsAtStartOfStatement = true;
     return AsmToken(AsmToken::EndOfStatement,
-                    StringRef(TokStart, strlen(MAI.getSeparatorString())));
+                    StringRef(TokStart, SeparatorString.size()));
   }
 
   // If we're missing a newline at EOF, make sure we still get an
@@ -12,8 +12,10 @@
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/BinaryFormat/COFF.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cassert>
 #include <cstddef>
@@ -116,6 +118,98 @@ tailcall:
   }
 }
 
+static cl::opt<bool> ParallelSortStringTables(
+    "parallel-sort-string-tables", cl::Hidden, cl::init(true),
+    cl::desc("Sort large string tables for tail merging concurrently"));
+
+// Tables with fewer strings than this are sorted on the calling thread.
+static const size_t ParallelSortThreshold = 1 << 16;
+
+// parallelMultikeySort splits the strings until each bucket has at most this
+// many, and then sorts each bucket as one task.
+static const size_t ParallelSortBucketSize = 1 << 12;
+
+namespace {
+// Strings that agree on their last Pos characters.
+struct TailBucket {
+  MutableArrayRef<StringPair *> Strings;
+  int Pos;
+};
+} // end anonymous namespace
+
+// Distributes the strings of B by their character at B.Pos, highest first as
+// in multikeySort order, and appends the resulting buckets to Buckets. Scratch
+// is as large as B.Strings and holds them while they are distributed.
+static void splitTailBucket(TailBucket B, MutableArrayRef<StringPair *> Scratch,
+                            std::vector<TailBucket> &Buckets) {
+  // Index 0 is for strings shorter than B.Pos + 1 characters.
+  size_t Begin[257] = {};
+  for (StringPair *P : B.Strings)
+    ++Begin[charTailAt(P, B.Pos) + 1];
+
+  // Strings sharing a long suffix need no moving until they differ.
+  int First = charTailAt(B.Strings[0], B.Pos);
+  if (First != -1 && Begin[First + 1] == B.Strings.size()) {
+    Buckets.push_back({B.Strings, B.Pos + 1});
+    return;
+  }
+
+  // Lay the buckets out highest first and turn the counts into offsets.
+  size_t Offset = 0;
+  for (size_t C = 257; C-- > 0;) {
+    size_t Count = Begin[C];
+    Begin[C] = Offset;
+    Offset += Count;
+  }
+
+  // After distribution, End[C] is one past the last string of bucket C.
+  size_t End[257];
+  std::copy(std::begin(Begin), std::end(Begin), std::begin(End));
+  for (StringPair *P : B.Strings)
+    Scratch[End[charTailAt(P, B.Pos) + 1]++] = P;
+  std::copy(Scratch.begin(), Scratch.end(), B.Strings.begin());
+
+  // The strings are unique, so at most one ends before B.Pos and it is
+  // already in place.
+  for (size_t C = 257; C-- > 1;)
+    if (End[C] - Begin[C] > 1)
+      Buckets.push_back(
+          {B.Strings.slice(Begin[C], End[C] - Begin[C]), B.Pos + 1});
+}
+
+// Same result as multikeySort(Vec, 0), but the strings are first distributed
+// into buckets by their last characters, which are then sorted concurrently.
+// Buckets with more than ParallelSortBucketSize strings are split again on the
+// next character, so that strings sharing a long suffix are spread out too.
+// The strings are unique, so the final order does not depend on how the work
+// is split.
+static void parallelMultikeySort(MutableArrayRef<StringPair *> Vec) {
+  std::vector<StringPair *> Scratch(Vec.size());
+  MutableArrayRef<StringPair *> ScratchRef(Scratch);
+  std::vector<TailBucket> ToSplit = {{Vec, 0}};
+  std::vector<TailBucket> ToSort;
+  while (!ToSplit.empty()) {
+    std::vector<std::vector<TailBucket>> Split(ToSplit.size());
+    parallel::for_each_n(parallel::par, size_t(0), ToSplit.size(),
+                         [&](size_t I) {
+                           TailBucket B = ToSplit[I];
+                           size_t Start = B.Strings.data() - Vec.data();
+                           splitTailBucket(
+                               B, ScratchRef.slice(Start, B.Strings.size()),
+                               Split[I]);
+                         });
+    ToSplit.clear();
+    for (std::vector<TailBucket> &Buckets : Split)
+      for (TailBucket &B : Buckets)
+        (B.Strings.size() > ParallelSortBucketSize ? ToSplit : ToSort)
+            .push_back(B);
+  }
+
+  parallel::for_each_n(parallel::par, size_t(0), ToSort.size(), [&](size_t I) {
+    multikeySort(ToSort[I].Strings, ToSort[I].Pos);
+  });
+}
+
 void StringTableBuilder::finalize() {
   assert(K != DWARF);
   finalizeStringTable(/*Optimize=*/true);
@@ -134,7 +228,10 @@ void StringTableBuilder::finalizeStringTable(bool Optimize) {
     for (StringPair &P : StringIndexMap)
       Strings.push_back(&P);
 
-    multikeySort(Strings, 0);
+    if (!ParallelSortStringTables || Strings.size() < ParallelSortThreshold)
+      multikeySort(Strings, 0);
+    else
+      parallelMultikeySort(Strings);
     initSize();
 
     StringRef Previous;
@@ -976,19 +976,18 @@ uint32_t Archive::getNumberOfSymbols() const {
 }
 
 Expected<Optional<Archive::Child>> Archive::findSym(StringRef name) const {
-  Archive::symbol_iterator bs = symbol_begin();
-  Archive::symbol_iterator es = symbol_end();
-
-  for (; bs != es; ++bs) {
-    StringRef SymName = bs->getName();
-    if (SymName == name) {
-      if (auto MemberOrErr = bs->getMember())
-        return Child(*MemberOrErr);
-      else
-        return MemberOrErr.takeError();
-    }
-  }
-  return Optional<Child>();
+  llvm::call_once(SymbolIndexOnce, [this] {
+    for (const Symbol &Sym : symbols())
+      SymbolIndex.try_emplace(Sym.getName(), Sym);
+  });
+
+  auto It = SymbolIndex.find(name);
+  if (It == SymbolIndex.end())
+    return Optional<Child>();
+  if (auto MemberOrErr = It->second.getMember())
+    return Child(*MemberOrErr);
+  else
+    return MemberOrErr.takeError();
 }
 
 // Returns true if archive file contains no member file.
@@ -23,6 +23,7 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/raw_ostream.h"
@@ -418,9 +419,29 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
   // symbol table is aligned to be a multiple of 8 bytes
   uint64_t Pos = 0;
 
+  // Reading the symbol tables means parsing every member, which is by far
+  // the most expensive part. The members are independent, so extract their
+  // symbol names concurrently into separate buffers; they are appended to
+  // SymNames below in member order, which keeps the output deterministic.
+  struct MemberSymbols {
+    std::string Names;
+    bool HasObject = false;
+    Optional<Expected<std::vector<unsigned>>> Offsets;
+  };
+  std::vector<MemberSymbols> MemberSyms(NewMembers.size());
+  parallel::for_each_n(
+      parallel::par, size_t(0), NewMembers.size(), [&](size_t I) {
+        MemberSymbols &MS = MemberSyms[I];
+        raw_string_ostream Names(MS.Names);
+        MS.Offsets.emplace(getSymbols(NewMembers[I].Buf->getMemBufferRef(),
+                                      Names, MS.HasObject));
+        Names.flush();
+      });
+
   std::vector<MemberData> Ret;
   bool HasObject = false;
-  for (const NewArchiveMember &M : NewMembers) {
+  for (size_t I = 0, E = NewMembers.size(); I != E; ++I) {
+    const NewArchiveMember &M = NewMembers[I];
     std::string Header;
     raw_string_ostream Out(Header);
 
@@ -441,10 +462,20 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                       Buf.getBufferSize() + MemberPadding);
     Out.flush();
 
-    Expected<std::vector<unsigned>> Symbols =
-        getSymbols(Buf, SymNames, HasObject);
-    if (auto E = Symbols.takeError())
-      return std::move(E);
+    MemberSymbols &MS = MemberSyms[I];
+    Expected<std::vector<unsigned>> &Symbols = *MS.Offsets;
+    if (!Symbols) {
+      // Report the first failing member, as the serial loop would have;
+      // later members' results are dropped.
+      for (size_t J = I + 1; J != E; ++J)
+        consumeError(MemberSyms[J].Offsets->takeError());
+      return Symbols.takeError();
+    }
+    HasObject |= MS.HasObject;
+    uint64_t SymNamesOffset = SymNames.tell();
+    for (unsigned &Offset : *Symbols)
+      Offset += SymNamesOffset;
+    SymNames << MS.Names;
 
     Pos += Header.size() + Data.size() + Padding.size();
     Ret.push_back({std::move(*Symbols), std::move(Header), Data, Padding});
@@ -14,6 +14,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Transforms/IPO/FunctionAttrs.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SCCIterator.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SetVector.h"
@@ -37,11 +38,13 @@
 #include "llvm/IR/Constant.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
 #include "llvm/IR/InstIterator.h"
 #include "llvm/IR/InstrTypes.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Metadata.h"
+#include "llvm/IR/Operator.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Use.h"
@@ -53,6 +56,7 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO.h"
 #include <cassert>
@@ -88,6 +92,12 @@ static cl::opt<bool> DisableNoUnwindInference(
     "disable-nounwind-inference", cl::Hidden,
     cl::desc("Stop inferring nounwind attribute during function-attrs pass"));
 
+static cl::opt<bool> UseEffectSummaries(
+    "function-attrs-use-summaries", cl::Hidden,
+    cl::desc("Infer readnone/readonly, nocapture, nounwind and norecurse in "
+             "the function-attrs pass from cached function effect summaries "
+             "instead of scanning the function bodies on every visit"));
+
 namespace {
 
 using SCCNodeSet = SmallSetVector<Function *, 8>;
@@ -226,36 +236,10 @@ MemoryAccessKind llvm::computeFunctionBodyMemoryAccess(Function &F,
   return checkFunctionMemoryAccess(F, /*ThisBody=*/true, AAR, {});
 }
 
-/// Deduce readonly/readnone attributes for the SCC.
-template <typename AARGetterT>
-static bool addReadAttrs(const SCCNodeSet &SCCNodes, AARGetterT &&AARGetter) {
-  // Check if any of the functions in the SCC read or write memory.  If they
-  // write memory then they can't be marked readnone or readonly.
-  bool ReadsMemory = false;
-  bool WritesMemory = false;
-  for (Function *F : SCCNodes) {
-    // Call the callable parameter to look up AA results for this function.
-    AAResults &AAR = AARGetter(*F);
-
-    // Non-exact function definitions may not be selected at link time, and an
-    // alternative version that writes to memory may be selected.  See the
-    // comment on GlobalValue::isDefinitionExact for more details.
-    switch (checkFunctionMemoryAccess(*F, F->hasExactDefinition(),
-                                      AAR, SCCNodes)) {
-    case MAK_MayWrite:
-      return false;
-    case MAK_ReadOnly:
-      ReadsMemory = true;
-      break;
-    case MAK_WriteOnly:
-      WritesMemory = true;
-      break;
-    case MAK_ReadNone:
-      // Nothing to do!
-      break;
-    }
-  }
-
+/// Give the functions in the SCC the readnone, readonly or writeonly attribute
+/// matching the memory accesses found in them.
+static bool setReadAttrs(const SCCNodeSet &SCCNodes, bool ReadsMemory,
+                         bool WritesMemory) {
   // Success!  Functions in this SCC do not access memory, or only read memory.
   // Give them the appropriate attribute.
   bool MadeChange = false;
@@ -305,6 +289,39 @@ static bool addReadAttrs(const SCCNodeSet &SCCNodes, AARGetterT &&AARGetter) {
   return MadeChange;
 }
 
+/// Deduce readonly/readnone attributes for the SCC.
+template <typename AARGetterT>
+static bool addReadAttrs(const SCCNodeSet &SCCNodes, AARGetterT &&AARGetter) {
+  // Check if any of the functions in the SCC read or write memory.  If they
+  // write memory then they can't be marked readnone or readonly.
+  bool ReadsMemory = false;
+  bool WritesMemory = false;
+  for (Function *F : SCCNodes) {
+    // Call the callable parameter to look up AA results for this function.
+    AAResults &AAR = AARGetter(*F);
+
+    // Non-exact function definitions may not be selected at link time, and an
+    // alternative version that writes to memory may be selected.  See the
+    // comment on GlobalValue::isDefinitionExact for more details.
+    switch (checkFunctionMemoryAccess(*F, F->hasExactDefinition(),
+                                      AAR, SCCNodes)) {
+    case MAK_MayWrite:
+      return false;
+    case MAK_ReadOnly:
+      ReadsMemory = true;
+      break;
+    case MAK_WriteOnly:
+      WritesMemory = true;
+      break;
+    case MAK_ReadNone:
+      // Nothing to do!
+      break;
+    }
+  }
+
+  return setReadAttrs(SCCNodes, ReadsMemory, WritesMemory);
+}
+
 namespace {
 
 /// For a given pointer Argument, this retains a list of Arguments of functions
@@ -1232,10 +1249,11 @@ static bool InstrBreaksNonThrowing(Instruction &I, const SCCNodeSet &SCCNodes) {
 /// instruction for compliance to the attribute assumptions. Currently it
 /// does:
 ///   - removal of Convergent attribute
-///   - addition of NoUnwind attribute
+///   - addition of NoUnwind attribute, unless \p InferNoUnwind is false
 ///
 /// Returns true if any changes to function attributes were made.
-static bool inferAttrsFromFunctionBodies(const SCCNodeSet &SCCNodes) {
+static bool inferAttrsFromFunctionBodies(const SCCNodeSet &SCCNodes,
+                                         bool InferNoUnwind) {
 
   AttributeInferer AI;
 
@@ -1259,7 +1277,7 @@ static bool inferAttrsFromFunctionBodies(const SCCNodeSet &SCCNodes) {
       },
       /* RequiresExactDefinition= */ false});
 
-  if (!DisableNoUnwindInference)
+  if (InferNoUnwind && !DisableNoUnwindInference)
     // Request to infer nounwind attribute for all the functions in the SCC if
     // every callsite within the SCC is not throwing (except for calls to
     // functions within the SCC). Note that nounwind attribute suffers from
@@ -1339,13 +1357,346 @@ static bool deriveAttrsInPostOrder(SCCNodeSet &SCCNodes, AARGetterT &&AARGetter,
   if (!HasUnknownCall) {
     Changed |= addNoAliasAttrs(SCCNodes);
     Changed |= addNonNullAttrs(SCCNodes);
-    Changed |= inferAttrsFromFunctionBodies(SCCNodes);
+    Changed |= inferAttrsFromFunctionBodies(SCCNodes, /*InferNoUnwind=*/true);
     Changed |= addNoRecurseAttrs(SCCNodes);
   }
 
   return Changed;
 }
 
+/// Returns true if \p Ptr is known to point to memory local to the function or
+/// to constant memory. Unlike AAResults::pointsToConstantMemory this never
+/// simplifies instructions, which may create new constants, so it can be used
+/// while other functions are summarized concurrently.
+static bool pointsToLocalOrConstantMemory(const Value *Ptr) {
+  SmallPtrSet<const Value *, 8> Visited;
+  SmallVector<const Value *, 8> Worklist;
+  Worklist.push_back(Ptr);
+  do {
+    const Value *V = Worklist.pop_back_val();
+    if (!Visited.insert(V).second)
+      continue;
+    // Give up on long chains, the way BasicAA does.
+    if (Visited.size() > 8)
+      return false;
+
+    if (auto *GEP = dyn_cast<GEPOperator>(V))
+      Worklist.push_back(GEP->getPointerOperand());
+    else if (Operator::getOpcode(V) == Instruction::BitCast ||
+             Operator::getOpcode(V) == Instruction::AddrSpaceCast)
+      Worklist.push_back(cast<Operator>(V)->getOperand(0));
+    else if (auto *SI = dyn_cast<SelectInst>(V)) {
+      Worklist.push_back(SI->getTrueValue());
+      Worklist.push_back(SI->getFalseValue());
+    } else if (auto *PN = dyn_cast<PHINode>(V))
+      Worklist.append(PN->op_begin(), PN->op_end());
+    else if (auto *GV = dyn_cast<GlobalVariable>(V)) {
+      if (!GV->isConstant())
+        return false;
+    } else if (!isa<AllocaInst>(V))
+      return false;
+  } while (!Worklist.empty());
+  return true;
+}
+
+namespace {
+
+/// Like ArgumentUsesTracker, but records every argument of a direct callee
+/// that the pointer is passed to, since the callees are only resolved when the
+/// summary is used.
+struct ArgumentSummaryTracker : public CaptureTracker {
+  void tooManyUses() override { Captured = true; }
+
+  bool captured(const Use *U) override {
+    CallSite CS(U->getUser());
+    Function *F = CS ? CS.getCalledFunction() : nullptr;
+    if (!F) {
+      Captured = true;
+      return true;
+    }
+
+    unsigned UseIndex =
+        std::distance(const_cast<const Use *>(CS.arg_begin()), U);
+
+    // Bundle operands and variadic arguments capture in some unknown way.
+    if (UseIndex >= CS.getNumArgOperands() || UseIndex >= F->arg_size()) {
+      Captured = true;
+      return true;
+    }
+
+    // Not F->arg_begin(): that would create F's arguments, racing with the
+    // summary of F if it is computed concurrently.
+    PassedTo.push_back({F, UseIndex});
+    return false;
+  }
+
+  // True only if certainly captured.
+  bool Captured = false;
+
+  // Arguments of direct callees the pointer is passed to.
+  SmallVector<FunctionEffectSummary::CalleeArgument, 2> PassedTo;
+};
+
+} // end anonymous namespace
+
+FunctionEffectSummary llvm::computeFunctionEffectSummary(Function &F) {
+  FunctionEffectSummary Summary;
+
+  for (Instruction &I : instructions(F)) {
+    if (auto CS = CallSite(&I)) {
+      if (!CS.getCalledFunction())
+        Summary.HasIndirectCall = true;
+      bool OnlyLocalArguments = llvm::all_of(CS.args(), [](const Value *Arg) {
+        return !Arg->getType()->isPtrOrPtrVectorTy() ||
+               pointsToLocalOrConstantMemory(Arg);
+      });
+      Summary.Calls.push_back({&I, OnlyLocalArguments});
+      continue;
+    }
+
+    Summary.MayThrow |= I.mayThrow();
+
+    // Ignore non-volatile accesses to local or constant memory, as
+    // checkFunctionMemoryAccess does.
+    if (auto *LI = dyn_cast<LoadInst>(&I)) {
+      if (!LI->isVolatile() &&
+          pointsToLocalOrConstantMemory(LI->getPointerOperand()))
+        continue;
+    } else if (auto *SI = dyn_cast<StoreInst>(&I)) {
+      if (!SI->isVolatile() &&
+          pointsToLocalOrConstantMemory(SI->getPointerOperand()))
+        continue;
+    } else if (auto *VI = dyn_cast<VAArgInst>(&I)) {
+      if (pointsToLocalOrConstantMemory(VI->getPointerOperand()))
+        continue;
+    }
+
+    Summary.WritesMemory |= I.mayWriteToMemory();
+    Summary.ReadsMemory |= I.mayReadFromMemory();
+  }
+
+  for (Argument &A : F.args()) {
+    if (!A.getType()->isPointerTy() || A.hasNoCaptureAttr())
+      continue;
+    ArgumentSummaryTracker Tracker;
+    PointerMayBeCaptured(&A, &Tracker);
+    if (!Tracker.Captured)
+      Summary.UncapturedArgs.push_back({&A, std::move(Tracker.PassedTo)});
+  }
+
+  return Summary;
+}
+
+AnalysisKey FunctionEffectsAnalysis::Key;
+
+FunctionEffectSummary FunctionEffectsAnalysis::run(Function &F,
+                                                   FunctionAnalysisManager &) {
+  return computeFunctionEffectSummary(F);
+}
+
+/// Deduce readonly/readnone/writeonly attributes for the SCC from the effect
+/// summaries of its functions.
+template <typename SummaryGetterT>
+static bool addReadAttrsFromSummaries(const SCCNodeSet &SCCNodes,
+                                      SummaryGetterT &&GetSummary) {
+  bool ReadsMemory = false;
+  bool WritesMemory = false;
+  for (Function *F : SCCNodes) {
+    if (F->doesNotAccessMemory())
+      continue;
+
+    // Only the attributes of non-exact definitions can be trusted, see
+    // addReadAttrs.
+    if (!F->hasExactDefinition()) {
+      if (F->onlyReadsMemory())
+        ReadsMemory = true;
+      else if (F->doesNotReadMemory())
+        WritesMemory = true;
+      else
+        return false;
+      continue;
+    }
+
+    const FunctionEffectSummary &Summary = GetSummary(*F);
+    ReadsMemory |= Summary.ReadsMemory;
+    WritesMemory |= Summary.WritesMemory;
+    for (const FunctionEffectSummary::CallEffect &CE : Summary.Calls) {
+      CallSite CS(CE.Call);
+      // Ignore calls to functions in the same SCC without operand bundles.
+      Function *Callee = CS.getCalledFunction();
+      if (!CS.hasOperandBundles() && Callee && SCCNodes.count(Callee))
+        continue;
+      if (CS.doesNotAccessMemory() ||
+          (CS.onlyAccessesArgMemory() && CE.OnlyLocalArguments))
+        continue;
+      ReadsMemory |= !CS.doesNotReadMemory();
+      WritesMemory |= !CS.onlyReadsMemory();
+    }
+
+    if (ReadsMemory && WritesMemory)
+      return false;
+  }
+
+  return setReadAttrs(SCCNodes, ReadsMemory, WritesMemory);
+}
+
+/// Deduce nocapture attributes for the SCC from the effect summaries of its
+/// functions. An argument is not captured if the arguments it is passed to are
+/// not captured either; within the SCC this is solved optimistically.
+template <typename SummaryGetterT>
+static bool addNoCaptureAttrsFromSummaries(const SCCNodeSet &SCCNodes,
+                                           SummaryGetterT &&GetSummary) {
+  bool Changed = false;
+
+  // The arguments in the SCC that are not captured by their function, and the
+  // arguments they are passed to.
+  MapVector<Argument *, ArrayRef<FunctionEffectSummary::CalleeArgument>>
+      Candidates;
+  for (Function *F : SCCNodes) {
+    if (!F->hasExactDefinition())
+      continue;
+
+    // Functions that are readonly (or readnone) and nounwind and don't return
+    // a value can't capture arguments.
+    if (F->onlyReadsMemory() && F->doesNotThrow() &&
+        F->getReturnType()->isVoidTy()) {
+      for (Argument &A : F->args()) {
+        if (A.getType()->isPointerTy() && !A.hasNoCaptureAttr()) {
+          A.addAttr(Attribute::NoCapture);
+          ++NumNoCapture;
+          Changed = true;
+        }
+      }
+      continue;
+    }
+
+    for (const FunctionEffectSummary::ArgumentEffect &AE :
+         GetSummary(*F).UncapturedArgs)
+      if (!AE.Arg->hasNoCaptureAttr())
+        Candidates[AE.Arg] = AE.PassedTo;
+  }
+
+  // Arguments passed to a candidate, and the candidates known to be captured
+  // because they are passed to an argument that is.
+  DenseMap<Argument *, SmallVector<Argument *, 2>> PassedFrom;
+  SmallPtrSet<Argument *, 8> Captured;
+  SmallVector<Argument *, 8> Worklist;
+  for (const auto &C : Candidates)
+    for (const FunctionEffectSummary::CalleeArgument &CA : C.second) {
+      Argument *To = &*std::next(CA.Callee->arg_begin(), CA.ArgNo);
+      if (To->hasNoCaptureAttr())
+        continue;
+      if (Candidates.count(To))
+        PassedFrom[To].push_back(C.first);
+      else if (Captured.insert(C.first).second)
+        Worklist.push_back(C.first);
+    }
+
+  while (!Worklist.empty()) {
+    auto It = PassedFrom.find(Worklist.pop_back_val());
+    if (It == PassedFrom.end())
+      continue;
+    for (Argument *From : It->second)
+      if (Captured.insert(From).second)
+        Worklist.push_back(From);
+  }
+
+  for (const auto &C : Candidates) {
+    if (Captured.count(C.first))
+      continue;
+    C.first->addAttr(Attribute::NoCapture);
+    ++NumNoCapture;
+    Changed = true;
+  }
+
+  return Changed;
+}
+
+/// Deduce nounwind attributes for the SCC from the effect summaries of its
+/// functions, with the same rules as inferAttrsFromFunctionBodies.
+template <typename SummaryGetterT>
+static bool addNoUnwindAttrsFromSummaries(const SCCNodeSet &SCCNodes,
+                                          SummaryGetterT &&GetSummary) {
+  if (DisableNoUnwindInference)
+    return false;
+
+  for (Function *F : SCCNodes) {
+    if (F->doesNotThrow())
+      continue;
+    if (!F->hasExactDefinition())
+      return false;
+
+    const FunctionEffectSummary &Summary = GetSummary(*F);
+    if (Summary.MayThrow)
+      return false;
+    for (const FunctionEffectSummary::CallEffect &CE : Summary.Calls) {
+      if (!CE.Call->mayThrow())
+        continue;
+      // A may-throw call to a function inside the SCC is fine as long as that
+      // function does not throw either.
+      auto *CI = dyn_cast<CallInst>(CE.Call);
+      if (!CI || !CI->getCalledFunction() ||
+          !SCCNodes.count(CI->getCalledFunction()))
+        return false;
+    }
+  }
+
+  bool Changed = false;
+  for (Function *F : SCCNodes) {
+    if (F->doesNotThrow())
+      continue;
+    LLVM_DEBUG(dbgs() << "Adding nounwind attr to fn " << F->getName()
+                      << "\n");
+    F->setDoesNotThrow();
+    ++NumNoUnwind;
+    Changed = true;
+  }
+  return Changed;
+}
+
+/// Deduce norecurse for a single function SCC from its effect summary, with
+/// the same rules as addNoRecurseAttrs.
+template <typename SummaryGetterT>
+static bool addNoRecurseAttrsFromSummaries(const SCCNodeSet &SCCNodes,
+                                           SummaryGetterT &&GetSummary) {
+  if (SCCNodes.size() != 1)
+    return false;
+
+  Function *F = *SCCNodes.begin();
+  if (F->isDeclaration() || F->doesNotRecurse())
+    return false;
+
+  for (const FunctionEffectSummary::CallEffect &CE : GetSummary(*F).Calls) {
+    Function *Callee = CallSite(CE.Call).getCalledFunction();
+    if (!Callee || Callee == F || !Callee->doesNotRecurse())
+      return false;
+  }
+
+  return setDoesNotRecurse(*F);
+}
+
+/// Deduce the attributes covered by function effect summaries for the SCC.
+template <typename SummaryGetterT>
+static bool deriveAttrsFromSummaries(const SCCNodeSet &SCCNodes,
+                                     SummaryGetterT &&GetSummary,
+                                     bool HasUnknownCall) {
+  bool Changed = false;
+
+  // Bail if the SCC only contains optnone functions.
+  if (SCCNodes.empty())
+    return Changed;
+
+  Changed |= addReadAttrsFromSummaries(SCCNodes, GetSummary);
+  Changed |= addNoCaptureAttrsFromSummaries(SCCNodes, GetSummary);
+
+  if (!HasUnknownCall) {
+    Changed |= addNoUnwindAttrsFromSummaries(SCCNodes, GetSummary);
+    Changed |= addNoRecurseAttrsFromSummaries(SCCNodes, GetSummary);
+  }
+
+  return Changed;
+}
+
 PreservedAnalyses PostOrderFunctionAttrsPass::run(LazyCallGraph::SCC &C,
                                                   CGSCCAnalysisManager &AM,
                                                   LazyCallGraph &CG,
@@ -1358,6 +1709,9 @@ PreservedAnalyses PostOrderFunctionAttrsPass::run(LazyCallGraph::SCC &C,
   auto AARGetter = [&](Function &F) -> AAResults & {
     return FAM.getResult<AAManager>(F);
   };
+  auto SummaryGetter = [&](Function &F) -> const FunctionEffectSummary & {
+    return FAM.getResult<FunctionEffectsAnalysis>(F);
+  };
 
   // Fill SCCNodes with the elements of the SCC. Also track whether there are
   // any external or opt-none nodes that will prevent us from optimizing any
@@ -1377,7 +1731,9 @@ PreservedAnalyses PostOrderFunctionAttrsPass::run(LazyCallGraph::SCC &C,
     // Note: if this is ever a performance hit, we can common it with
     // subsequent routines which also do scans over the instructions of the
     // function.
-    if (!HasUnknownCall)
+    if (UseEffectSummaries)
+      HasUnknownCall |= SummaryGetter(F).HasIndirectCall;
+    else if (!HasUnknownCall)
       for (Instruction &I : instructions(F))
         if (auto CS = CallSite(&I))
           if (!CS.getCalledFunction()) {
@@ -1388,10 +1744,34 @@ PreservedAnalyses PostOrderFunctionAttrsPass::run(LazyCallGraph::SCC &C,
     SCCNodes.insert(&F);
   }
 
-  if (deriveAttrsInPostOrder(SCCNodes, AARGetter, HasUnknownCall))
-    return PreservedAnalyses::none();
+  if (!UseEffectSummaries) {
+    if (deriveAttrsInPostOrder(SCCNodes, AARGetter, HasUnknownCall))
+      return PreservedAnalyses::none();
+    return PreservedAnalyses::all();
+  }
+
+  // The summaries cover the attributes that need a scan of the whole body; the
+  // remaining ones only look at the returned values or at convergent functions.
+  // Readonly and readnone arguments are not inferred in this mode.
+  bool Changed = false;
+  if (!SCCNodes.empty()) {
+    Changed |= addArgumentReturnedAttrs(SCCNodes);
+    Changed |= deriveAttrsFromSummaries(SCCNodes, SummaryGetter, HasUnknownCall);
+    if (!HasUnknownCall) {
+      Changed |= addNoAliasAttrs(SCCNodes);
+      Changed |= addNonNullAttrs(SCCNodes);
+      Changed |= inferAttrsFromFunctionBodies(SCCNodes, /*InferNoUnwind=*/false);
+    }
+  }
+  if (!Changed)
+    return PreservedAnalyses::all();
 
-  return PreservedAnalyses::all();
+  // Only attributes were changed, so the summaries of the bodies stay valid
+  // for the next visit of these functions.
+  PreservedAnalyses PA;
+  PA.preserve<FunctionAnalysisManagerCGSCCProxy>();
+  PA.preserve<FunctionEffectsAnalysis>();
+  return PA;
 }
 
 namespace {
@@ -1569,3 +1949,133 @@ ReversePostOrderFunctionAttrsPass::run(Module &M, ModuleAnalysisManager &AM) {
   PA.preserve<CallGraphAnalysis>();
   return PA;
 }
+
+namespace {
+
+/// The effect summaries of all the function definitions in a module. The ones
+/// not already available are computed in parallel.
+class ModuleEffectSummaries {
+  DenseMap<const Function *, const FunctionEffectSummary *> Summaries;
+  std::vector<FunctionEffectSummary> Computed;
+
+public:
+  template <typename CachedGetterT>
+  ModuleEffectSummaries(Module &M, CachedGetterT &&GetCached) {
+    std::vector<Function *> Missing;
+    for (Function &F : M) {
+      if (F.isDeclaration())
+        continue;
+      if (const FunctionEffectSummary *Summary = GetCached(F))
+        Summaries[&F] = Summary;
+      else
+        Missing.push_back(&F);
+    }
+
+    Computed.resize(Missing.size());
+    parallel::for_each_n(parallel::par, size_t(0), Missing.size(),
+                         [&](size_t I) {
+                           Computed[I] = computeFunctionEffectSummary(
+                               *Missing[I]);
+                         });
+    for (size_t I = 0, E = Missing.size(); I != E; ++I)
+      Summaries[Missing[I]] = &Computed[I];
+  }
+
+  const FunctionEffectSummary &operator()(Function &F) const {
+    assert(Summaries.count(&F) && "No summary for a declaration!");
+    return *Summaries.lookup(&F);
+  }
+};
+
+} // end anonymous namespace
+
+static bool deriveAttrsFromSummariesInPostOrder(
+    CallGraph &CG, const ModuleEffectSummaries &Summaries) {
+  bool Changed = false;
+  for (scc_iterator<CallGraph *> I = scc_begin(&CG); !I.isAtEnd(); ++I) {
+    // As in the legacy post-order pass, external nodes and functions we are
+    // trying not to optimize are left out of the SCC and block the inferences
+    // that need to see every call.
+    SCCNodeSet SCCNodes;
+    bool HasUnknownCall = false;
+    for (CallGraphNode *N : *I) {
+      Function *F = N->getFunction();
+      if (!F || F->hasFnAttribute(Attribute::OptimizeNone) ||
+          F->hasFnAttribute(Attribute::Naked)) {
+        HasUnknownCall = true;
+        continue;
+      }
+      if (!F->isDeclaration() && Summaries(*F).HasIndirectCall)
+        HasUnknownCall = true;
+      SCCNodes.insert(F);
+    }
+
+    Changed |= deriveAttrsFromSummaries(SCCNodes, Summaries, HasUnknownCall);
+  }
+  return Changed;
+}
+
+PreservedAnalyses SummaryFunctionAttrsPass::run(Module &M,
+                                                ModuleAnalysisManager &AM) {
+  auto &CG = AM.getResult<CallGraphAnalysis>(M);
+  FunctionAnalysisManager &FAM =
+      AM.getResult<FunctionAnalysisManagerModuleProxy>(M).getManager();
+
+  ModuleEffectSummaries Summaries(M, [&](Function &F) {
+    return FAM.getCachedResult<FunctionEffectsAnalysis>(F);
+  });
+  if (!deriveAttrsFromSummariesInPostOrder(CG, Summaries))
+    return PreservedAnalyses::all();
+
+  PreservedAnalyses PA;
+  PA.preserve<CallGraphAnalysis>();
+  PA.preserve<FunctionAnalysisManagerModuleProxy>();
+  PA.preserve<FunctionEffectsAnalysis>();
+  return PA;
+}
+
+namespace {
+
+struct SummaryFunctionAttrsLegacyPass : public ModulePass {
+  // Pass identification, replacement for typeid
+  static char ID;
+
+  SummaryFunctionAttrsLegacyPass() : ModulePass(ID) {
+    initializeSummaryFunctionAttrsLegacyPassPass(
+        *PassRegistry::getPassRegistry());
+  }
+
+  bool runOnModule(Module &M) override;
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.setPreservesCFG();
+    AU.addRequired<CallGraphWrapperPass>();
+    AU.addPreserved<CallGraphWrapperPass>();
+  }
+};
+
+} // end anonymous namespace
+
+char SummaryFunctionAttrsLegacyPass::ID = 0;
+
+INITIALIZE_PASS_BEGIN(SummaryFunctionAttrsLegacyPass, "summary-functionattrs",
+                      "Deduce function attributes from effect summaries",
+                      false, false)
+INITIALIZE_PASS_DEPENDENCY(CallGraphWrapperPass)
+INITIALIZE_PASS_END(SummaryFunctionAttrsLegacyPass, "summary-functionattrs",
+                    "Deduce function attributes from effect summaries",
+                    false, false)
+
+Pass *llvm::createSummaryFunctionAttrsLegacyPass() {
+  return new SummaryFunctionAttrsLegacyPass();
+}
+
+bool SummaryFunctionAttrsLegacyPass::runOnModule(Module &M) {
+  if (skipModule(M))
+    return false;
+
+  auto &CG = getAnalysis<CallGraphWrapperPass>().getCallGraph();
+  ModuleEffectSummaries Summaries(
+      M, [](Function &) -> const FunctionEffectSummary * { return nullptr; });
+  return deriveAttrsFromSummariesInPostOrder(CG, Summaries);
+}
@@ -71,7 +71,8 @@ public:
     };
     return llvm::getInlineCost(CS, Params, TTI, GetAssumptionCache,
                                /*GetBFI=*/None, PSI,
-                               RemarksEnabled ? &ORE : nullptr);
+                               RemarksEnabled ? &ORE : nullptr,
+                               getCostSummaries(CS));
   }
 
   bool runOnSCC(CallGraphSCC &SCC) override;
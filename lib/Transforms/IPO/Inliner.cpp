@@ -121,6 +121,14 @@ static cl::opt<bool>
                                    " callsites processed by inliner but decided"
                                    " to be not inlined"));
 
+/// Flag to reuse the inline cost analysis of a callee for call sites that pass
+/// it similar arguments.
+static cl::opt<bool>
+    EnableInlineCostSummaries("inline-cost-summaries", cl::init(false),
+                              cl::Hidden,
+                              cl::desc("Cache the inline cost analysis of "
+                                       "callees for each argument pattern"));
+
 LegacyInlinerBase::LegacyInlinerBase(char &ID) : CallGraphSCCPass(ID) {}
 
 LegacyInlinerBase::LegacyInlinerBase(char &ID, bool InsertLifetime)
@@ -751,17 +759,37 @@ bool LegacyInlinerBase::inlineCalls(CallGraphSCC &SCC) {
   auto GetAssumptionCache = [&](Function &F) -> AssumptionCache & {
     return ACT->getAssumptionCache(F);
   };
+
+  // The functions of this SCC are inlined into, so their summaries, if any,
+  // are about to become stale.
+  CurrentSCCFunctions.clear();
+  for (CallGraphNode *Node : SCC)
+    if (Function *F = Node->getFunction()) {
+      CurrentSCCFunctions.insert(F);
+      CostSummaries.erase(F);
+    }
+
   return inlineCallsImpl(SCC, CG, GetAssumptionCache, PSI, TLI, InsertLifetime,
                          [this](CallSite CS) { return getInlineCost(CS); },
                          LegacyAARGetter(*this), ImportedFunctionsStats);
 }
 
+InlineCostSummaries *LegacyInlinerBase::getCostSummaries(CallSite CS) {
+  Function *Callee = CS.getCalledFunction();
+  if (!EnableInlineCostSummaries || !Callee ||
+      CurrentSCCFunctions.count(Callee))
+    return nullptr;
+  return &CostSummaries[Callee];
+}
+
 /// Remove now-dead linkonce functions at the end of
 /// processing to avoid breaking the SCC traversal.
 bool LegacyInlinerBase::doFinalization(CallGraph &CG) {
   if (InlinerFunctionImportStats != InlinerFunctionImportStatsOpts::No)
     ImportedFunctionsStats.dump(InlinerFunctionImportStats ==
                                 InlinerFunctionImportStatsOpts::Verbose);
+  CostSummaries.clear();
+  CurrentSCCFunctions.clear();
   return removeDeadFunctions(CG);
 }
 
@@ -995,8 +1023,14 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
     auto GetInlineCost = [&](CallSite CS) {
       Function &Callee = *CS.getCalledFunction();
       auto &CalleeTTI = FAM.getResult<TargetIRAnalysis>(Callee);
+      // Callees in this SCC may still be inlined into, so only the summaries
+      // of those in other SCCs are kept. Those are invalidated along with the
+      // other analyses of the callee when it is modified.
+      InlineCostSummaries *CalleeSummaries = nullptr;
+      if (EnableInlineCostSummaries && CG.lookupSCC(*CG.lookup(Callee)) != C)
+        CalleeSummaries = &FAM.getResult<InlineCostSummaryAnalysis>(Callee);
       return getInlineCost(CS, Params, CalleeTTI, GetAssumptionCache, {GetBFI},
-                           PSI, &ORE);
+                           PSI, &ORE, CalleeSummaries);
     };
 
     // Now process as many calls as we have within this caller in the sequnece.
@@ -1124,6 +1158,12 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
       continue;
     Changed = true;
 
+    // The SCC may have been split apart since the calls were collected, so the
+    // caller may no longer be in it and have summaries of its old body.
+    if (auto *CallerSummaries =
+            FAM.getCachedResult<InlineCostSummaryAnalysis>(F))
+      CallerSummaries->clear();
+
     // Add all the inlined callees' edges as ref edges to the caller. These are
     // by definition trivial edges as we always have *some* transitive ref edge
     // chain. While in some cases these edges are direct calls inside the
@@ -36,6 +36,15 @@
 // Collisions in the hash affect the speed of the pass but not the correctness
 // or determinism of the resulting transformation.
 //
+// The functions are picked with FunctionComparator::functionHash, which only
+// covers the opcodes, since functions that differ in a callee may become equal
+// once the callees are merged. The tree is then ordered by
+// FunctionComparator::functionFingerprint, which also covers the operands, so
+// that functions which only differ in a constant or a callee rarely share one.
+// The fingerprints of the functions picked are computed in parallel. Those
+// that share one are compared with each other, several groups at a time, and
+// those found equal are merged without being looked up in the tree again.
+//
 // When a match is found the functions are folded. If both functions are
 // overridable, we move the functionality into a new internal function and
 // leave two overridable thunks to it.
@@ -90,6 +99,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
@@ -100,16 +110,19 @@
 #include "llvm/IR/Constant.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/DataLayout.h"
 #include "llvm/IR/DebugLoc.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/GlobalValue.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/InstrTypes.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/Module.h"
+#include "llvm/IR/Operator.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Use.h"
 #include "llvm/IR/User.h"
@@ -120,6 +133,7 @@
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/Utils/FunctionComparator.h"
@@ -172,9 +186,8 @@ class FunctionNode {
   FunctionComparator::FunctionHash Hash;
 
 public:
-  // Note the hash is recalculated potentially multiple times, but it is cheap.
-  FunctionNode(Function *F)
-    : F(F), Hash(FunctionComparator::functionHash(*F))  {}
+  FunctionNode(Function *F, FunctionComparator::FunctionHash Hash)
+    : F(F), Hash(Hash)  {}
 
   Function *getFunc() const { return F; }
   FunctionComparator::FunctionHash getHash() const { return Hash; }
@@ -234,10 +247,24 @@ private:
   bool doSanityCheck(std::vector<WeakTrackingVH> &Worklist);
 #endif
 
+  /// Split the functions of each bucket of HashedFuncs, given as ranges of
+  /// equal hashes, into classes of equal functions, and record them in
+  /// Precomputed along with the hashes.
+  void findEqualFunctions(
+      Module &M,
+      ArrayRef<std::pair<FunctionComparator::FunctionHash, Function *>>
+          HashedFuncs,
+      ArrayRef<std::pair<size_t, size_t>> Buckets);
+
   /// Insert a ComparableFunction into the FnTree, or merge it away if it's
   /// equal to one that's already present.
   bool insert(Function *NewFunction);
 
+  /// Merge NewFunction with the function of Node, which it is equal to. Class
+  /// is the class of equal functions NewFunction belongs to, if known.
+  void mergeWithNode(FnTreeType::iterator Node, Function *NewFunction,
+                     unsigned Class);
+
   /// Remove a Function from the FnTree and queue it up for a second sweep of
   /// analysis.
   void remove(Function *F);
@@ -285,6 +312,21 @@ private:
   // dangling iterators into FnTree. The invariant that preserves this is that
   // there is exactly one mapping F -> FN for each FunctionNode FN in FnTree.
   ValueMap<Function*, FnTreeType::iterator> FNodesInTree;
+
+  /// What runOnModule found out about a function before inserting it for the
+  /// first time: its hash, and the class of equal functions it belongs to.
+  /// The entry is dropped when the function is inserted or modified.
+  struct PrecomputedInfo {
+    FunctionComparator::FunctionHash Hash;
+    unsigned Class;
+  };
+  DenseMap<Function *, PrecomputedInfo> Precomputed;
+
+  enum : unsigned { NoClass = ~0U };
+
+  /// For each class of equal functions, the function in FnTree the others
+  /// can be merged with, if any.
+  std::vector<WeakVH> ClassLeaders;
 };
 
 } // end anonymous namespace
@@ -393,6 +435,8 @@ bool MergeFunctions::runOnModule(Module &M) {
         return a.first < b.first;
       });
 
+  std::vector<std::pair<FunctionComparator::FunctionHash, Function *>>
+    FingerprintedFuncs;
   auto S = HashedFuncs.begin();
   for (auto I = HashedFuncs.begin(), IE = HashedFuncs.end(); I != IE; ++I) {
     // If the hash value matches the previous value or the next one, we must
@@ -400,9 +444,38 @@ bool MergeFunctions::runOnModule(Module &M) {
     if ((I != S && std::prev(I)->first == I->first) ||
         (std::next(I) != IE && std::next(I)->first == I->first) ) {
       Deferred.push_back(WeakTrackingVH(I->second));
+      FingerprintedFuncs.push_back({0, I->second});
     }
   }
 
+  // Fingerprinting only reads the IR of each function.
+  parallel::for_each_n(parallel::par, size_t(0), FingerprintedFuncs.size(),
+                       [&](size_t I) {
+                         FingerprintedFuncs[I].first =
+                             FunctionComparator::functionFingerprint(
+                                 *FingerprintedFuncs[I].second);
+                       });
+  for (const auto &FF : FingerprintedFuncs)
+    Precomputed[FF.second] = {FF.first, NoClass};
+
+  std::stable_sort(
+      FingerprintedFuncs.begin(), FingerprintedFuncs.end(),
+      [](const std::pair<FunctionComparator::FunctionHash, Function *> &a,
+         const std::pair<FunctionComparator::FunctionHash, Function *> &b) {
+        return a.first < b.first;
+      });
+
+  std::vector<std::pair<size_t, size_t>> Buckets;
+  for (size_t B = 0, E = FingerprintedFuncs.size(); B != E;) {
+    size_t I = B + 1;
+    while (I != E && FingerprintedFuncs[I].first == FingerprintedFuncs[B].first)
+      ++I;
+    if (I - B > 1)
+      Buckets.push_back({B, I});
+    B = I;
+  }
+  findEqualFunctions(M, FingerprintedFuncs, Buckets);
+
   do {
     std::vector<WeakTrackingVH> Worklist;
     Deferred.swap(Worklist);
@@ -426,10 +499,70 @@ bool MergeFunctions::runOnModule(Module &M) {
 
   FnTree.clear();
   GlobalNumbers.clear();
+  Precomputed.clear();
+  ClassLeaders.clear();
 
   return Changed;
 }
 
+void MergeFunctions::findEqualFunctions(
+    Module &M,
+    ArrayRef<std::pair<FunctionComparator::FunctionHash, Function *>>
+        HashedFuncs,
+    ArrayRef<std::pair<size_t, size_t>> Buckets) {
+  // Beyond this many classes in a bucket, which only happens when the hash
+  // misses what tells the functions apart, leave the rest to FnTree.
+  const unsigned MaxClassesPerBucket = 8;
+
+  // FunctionComparator asks for the integer type of pointers and for the
+  // layout of the structs that GEPs index into, both of which are created on
+  // first use. Create them up front so that the comparisons below only read
+  // them.
+  const DataLayout &DL = M.getDataLayout();
+  DL.getIntPtrType(M.getContext());
+  for (const auto &Bucket : Buckets)
+    for (size_t I = Bucket.first; I != Bucket.second; ++I)
+      for (Instruction &Inst : instructions(HashedFuncs[I].second))
+        if (auto *GEP = dyn_cast<GEPOperator>(&Inst)) {
+          APInt Offset(DL.getIndexSizeInBits(GEP->getPointerAddressSpace()),
+                       0);
+          GEP->accumulateConstantOffset(DL, Offset);
+        }
+
+  // The buckets are independent, so they are compared in parallel. Globals
+  // are compared by identity rather than with GlobalNumbers, which is not
+  // thread-safe; only equality is needed here.
+  std::vector<size_t> Leaders(HashedFuncs.size(), HashedFuncs.size());
+  parallel::for_each_n(parallel::par, size_t(0), Buckets.size(), [&](size_t B) {
+    SmallVector<size_t, 4> BucketLeaders;
+    for (size_t I = Buckets[B].first; I != Buckets[B].second; ++I) {
+      Function *F = HashedFuncs[I].second;
+      auto Equal = llvm::find_if(BucketLeaders, [&](size_t L) {
+        return FunctionComparator(HashedFuncs[L].second, F, nullptr)
+                   .compare() == 0;
+      });
+      if (Equal != BucketLeaders.end()) {
+        Leaders[I] = *Equal;
+      } else if (BucketLeaders.size() < MaxClassesPerBucket) {
+        BucketLeaders.push_back(I);
+        Leaders[I] = I;
+      }
+    }
+  });
+
+  std::vector<unsigned> Classes(HashedFuncs.size(), NoClass);
+  for (const auto &Bucket : Buckets) {
+    for (size_t I = Bucket.first; I != Bucket.second; ++I) {
+      if (Leaders[I] == I) {
+        Classes[I] = ClassLeaders.size();
+        ClassLeaders.emplace_back();
+      } else if (Leaders[I] != HashedFuncs.size())
+        Classes[I] = Classes[Leaders[I]];
+      Precomputed[HashedFuncs[I].second] = {HashedFuncs[I].first, Classes[I]};
+    }
+  }
+}
+
 // Replace direct callers of Old with New.
 void MergeFunctions::replaceDirectCallers(Function *Old, Function *New) {
   Constant *BitcastNew = ConstantExpr::getBitCast(New, Old->getType());
@@ -819,18 +952,47 @@ void MergeFunctions::replaceFunctionInTree(const FunctionNode &FN,
 // Insert a ComparableFunction into the FnTree, or merge it away if equal to one
 // that was already inserted.
 bool MergeFunctions::insert(Function *NewFunction) {
+  FunctionComparator::FunctionHash Hash;
+  unsigned Class = NoClass;
+  auto P = Precomputed.find(NewFunction);
+  if (P != Precomputed.end()) {
+    Hash = P->second.Hash;
+    Class = P->second.Class;
+    Precomputed.erase(P);
+  } else {
+    Hash = FunctionComparator::functionFingerprint(*NewFunction);
+  }
+
+  // If NewFunction is known to be equal to a function in the tree, merge them
+  // without comparing them again.
+  if (Class != NoClass && ClassLeaders[Class]) {
+    auto I = FNodesInTree.find(cast<Function>(ClassLeaders[Class]));
+    if (I != FNodesInTree.end()) {
+      mergeWithNode(I->second, NewFunction, Class);
+      return true;
+    }
+  }
+
   std::pair<FnTreeType::iterator, bool> Result =
-      FnTree.insert(FunctionNode(NewFunction));
+      FnTree.insert(FunctionNode(NewFunction, Hash));
 
   if (Result.second) {
     assert(FNodesInTree.count(NewFunction) == 0);
     FNodesInTree.insert({NewFunction, Result.first});
+    if (Class != NoClass)
+      ClassLeaders[Class] = NewFunction;
     LLVM_DEBUG(dbgs() << "Inserting as unique: " << NewFunction->getName()
                       << '\n');
     return false;
   }
 
-  const FunctionNode &OldF = *Result.first;
+  mergeWithNode(Result.first, NewFunction, Class);
+  return true;
+}
+
+void MergeFunctions::mergeWithNode(FnTreeType::iterator Node,
+                                   Function *NewFunction, unsigned Class) {
+  const FunctionNode &OldF = *Node;
 
   // Impose a total order (by name) on the replacement of functions. This is
   // important when operating on more than one module independently to prevent
@@ -842,22 +1004,26 @@ bool MergeFunctions::insert(Function *NewFunction) {
        OldF.getFunc()->getName() > NewFunction->getName())) {
     // Swap the two functions.
     Function *F = OldF.getFunc();
-    replaceFunctionInTree(*Result.first, NewFunction);
+    replaceFunctionInTree(*Node, NewFunction);
     NewFunction = F;
     assert(OldF.getFunc() != F && "Must have swapped the functions.");
   }
+  if (Class != NoClass)
+    ClassLeaders[Class] = OldF.getFunc();
 
   LLVM_DEBUG(dbgs() << "  " << OldF.getFunc()->getName()
                     << " == " << NewFunction->getName() << '\n');
 
   Function *DeleteF = NewFunction;
   mergeTwoFunctions(OldF.getFunc(), DeleteF);
-  return true;
 }
 
 // Remove a function from FnTree. If it was already in FnTree, add
 // it to Deferred so that we'll look at it in the next round.
 void MergeFunctions::remove(Function *F) {
+  // F is about to change, so what was found out about it beforehand no longer
+  // holds.
+  Precomputed.erase(F);
   auto I = FNodesInTree.find(F);
   if (I != FNodesInTree.end()) {
     LLVM_DEBUG(dbgs() << "Deferred " << F->getName() << ".\n");
@@ -35,6 +35,8 @@
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Analysis/MemoryBuiltins.h"
 #include "llvm/Analysis/MemoryDependenceAnalysis.h"
+#include "llvm/Analysis/MemorySSA.h"
+#include "llvm/Analysis/MemorySSAUpdater.h"
 #include "llvm/Analysis/OptimizationRemarkEmitter.h"
 #include "llvm/Analysis/PHITransAddr.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
@@ -99,6 +101,13 @@ static cl::opt<bool> EnablePRE("enable-pre",
                                cl::init(true), cl::Hidden);
 static cl::opt<bool> EnableLoadPRE("enable-load-pre", cl::init(true));
 static cl::opt<bool> EnableMemDep("enable-gvn-memdep", cl::init(true));
+// MemorySSA is built in addition to memdep, not instead of it: loads without
+// a dominating dependency and load PRE still go through memdep, so GVN keeps
+// requiring it in this mode.
+static cl::opt<bool> EnableMemorySSA(
+    "enable-gvn-memoryssa", cl::init(false), cl::Hidden,
+    cl::desc("Use MemorySSA to find the local and dominating dependencies of "
+             "loads; memdep is still used for the rest and for load PRE"));
 
 // Maximum allowed recursion depth.
 static cl::opt<uint32_t>
@@ -1449,6 +1458,44 @@ static void patchAndReplaceAllUsesWith(Instruction *I, Value *Repl) {
   I->replaceAllUsesWith(Repl);
 }
 
+/// Find the dependency of \p L from its clobbering access in MemorySSA rather
+/// than by scanning backwards with MD. An earlier load of the same pointer
+/// that dominates \p L and has the same clobber is returned as a Def.
+/// Otherwise a clobbering MemoryDef is classified as a Def or Clobber the way
+/// MD would, even if it lives in a dominating block. Live-on-entry and
+/// MemoryPhi clobbers are returned as non-local.
+MemDepResult GVN::getMemorySSADependency(LoadInst *L) {
+  auto *MU = dyn_cast_or_null<MemoryUse>(MSSA->getMemoryAccess(L));
+  // Loads inserted by load PRE in this iteration have no memory access. Uses
+  // that MemorySSA gave up optimizing when it was built have too many accesses
+  // above them to disambiguate, and the walker is not bounded across
+  // MemoryPhis in that case, so leave those to MD's bounded scan as well.
+  if (!MU || !L->isSimple() || !MU->isOptimized())
+    return MD->getDependency(L);
+
+  MemoryAccess *Clobber = MU->getOptimized();
+  SmallVectorImpl<WeakVH> &SameClobber =
+      LoadsByClobber[{Clobber, L->getPointerOperand()}];
+  for (WeakVH &V : SameClobber) {
+    // Null if the earlier load was erased since.
+    auto *Earlier = cast_or_null<LoadInst>(V);
+    if (Earlier && MSSA->dominates(MSSA->getMemoryAccess(Earlier), MU))
+      return MemDepResult::getDef(Earlier);
+  }
+  SameClobber.push_back(L);
+
+  if (MSSA->isLiveOnEntryDef(Clobber) || isa<MemoryPhi>(Clobber))
+    return MemDepResult::getNonLocal();
+
+  Instruction *DepInst = cast<MemoryDef>(Clobber)->getMemoryInst();
+  if (auto *SI = dyn_cast<StoreInst>(DepInst))
+    if (SI->isSimple() &&
+        VN.getAliasAnalysis()->alias(MemoryLocation::get(SI),
+                                     MemoryLocation::get(L)) == MustAlias)
+      return MemDepResult::getDef(SI);
+  return MemDepResult::getClobber(DepInst);
+}
+
 /// Attempt to eliminate a load, first by eliminating it
 /// locally, and then attempting non-local elimination if that fails.
 bool GVN::processLoad(LoadInst *L) {
@@ -1465,7 +1512,7 @@ bool GVN::processLoad(LoadInst *L) {
   }
 
   // ... to a pointer that has been loaded from before...
-  MemDepResult Dep = MD->getDependency(L);
+  MemDepResult Dep = MSSA ? getMemorySSADependency(L) : MD->getDependency(L);
 
   // If it is defined in another block, try harder.
   if (Dep.isNonLocal())
@@ -1497,6 +1544,12 @@ bool GVN::processLoad(LoadInst *L) {
     return true;
   }
 
+  // MemorySSA can find a dependency in a dominating block. If that does not
+  // make the load redundant, look for a partial redundancy with MD like we
+  // would have without MemorySSA.
+  if (MSSA && Dep.getInst()->getParent() != L->getParent())
+    return processNonLocalLoad(L);
+
   return false;
 }
 
@@ -2079,6 +2132,7 @@ bool GVN::processBlock(BasicBlock *BB) {
       LLVM_DEBUG(dbgs() << "GVN removed: " << *I << '\n');
       salvageDebugInfo(*I);
       if (MD) MD->removeInstruction(I);
+      if (MSSAU) MSSAU->removeMemoryAccess(I);
       LLVM_DEBUG(verifyRemoved(I));
       if (MaybeFirstICF == I) {
         // We have erased the first ICF in block. The map needs to be updated.
@@ -2338,6 +2392,9 @@ BasicBlock *GVN::splitCriticalEdges(BasicBlock *Pred, BasicBlock *Succ) {
       SplitCriticalEdge(Pred, Succ, CriticalEdgeSplittingOptions(DT));
   if (MD)
     MD->invalidateCachedPredecessors();
+  // MemorySSA is not updated for the new block; stop using it.
+  MSSA = nullptr;
+  MSSAU = nullptr;
   return BB;
 }
 
@@ -2352,6 +2409,8 @@ bool GVN::splitCriticalEdges() {
                       CriticalEdgeSplittingOptions(DT));
   } while (!toSplit.empty());
   if (MD) MD->invalidateCachedPredecessors();
+  MSSA = nullptr;
+  MSSAU = nullptr;
   return true;
 }
 
@@ -2366,9 +2425,22 @@ bool GVN::iterateOnFunction(Function &F) {
   // processBlock.
   ReversePostOrderTraversal<Function *> RPOT(&F);
 
+  // MemorySSA is rebuilt for each iteration since it is only kept up to date
+  // with instruction removal, not with the CFG changes GVN makes.
+  std::unique_ptr<MemorySSA> IterationMSSA;
+  std::unique_ptr<MemorySSAUpdater> IterationMSSAU;
+  if (MD && EnableMemorySSA) {
+    IterationMSSA = make_unique<MemorySSA>(F, VN.getAliasAnalysis(), DT);
+    IterationMSSAU = make_unique<MemorySSAUpdater>(IterationMSSA.get());
+    MSSA = IterationMSSA.get();
+    MSSAU = IterationMSSAU.get();
+  }
+
   for (BasicBlock *BB : RPOT)
     Changed |= processBlock(BB);
 
+  MSSA = nullptr;
+  MSSAU = nullptr;
   return Changed;
 }
 
@@ -2377,6 +2449,7 @@ void GVN::cleanupGlobalSets() {
   LeaderTable.clear();
   BlockRPONumber.clear();
   TableAllocator.Reset();
+  LoadsByClobber.clear();
   ICF->clear();
 }
 
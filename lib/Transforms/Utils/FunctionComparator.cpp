@@ -383,6 +383,9 @@ int FunctionComparator::cmpConstants(const Constant *L,
 }
 
 int FunctionComparator::cmpGlobalValues(GlobalValue *L, GlobalValue *R) const {
+  if (!GlobalNumbers)
+    return cmpNumbers(reinterpret_cast<uintptr_t>(L),
+                      reinterpret_cast<uintptr_t>(R));
   uint64_t LNumber = GlobalNumbers->getNumber(L);
   uint64_t RNumber = GlobalNumbers->getNumber(R);
   return cmpNumbers(LNumber, RNumber);
@@ -947,3 +950,255 @@ FunctionComparator::FunctionHash FunctionComparator::functionHash(Function &F) {
   }
   return H.getHash();
 }
+
+namespace {
+
+// Computes FunctionComparator::functionFingerprint. Everything hashed here is
+// something compare() requires to be equal for the functions to be equal, so
+// it can only tell apart functions that compare() would tell apart as well:
+//  * Pointers in address space 0 are hashed as the integers of the same size,
+//    like cmpTypes does.
+//  * All null constants hash the same, since cmpConstants treats nulls of
+//    bitcastable types as equal. Other constants are hashed by kind and value,
+//    but aggregates and constant expressions only by kind.
+//  * Globals are hashed by name. compare() only treats a global as equal to
+//    itself, and the pass updates the users of a global when it renames it.
+//  * Arguments, blocks and instructions are numbered in the order cmpValues
+//    first sees them, and hashed by their number. cmpValues requires these
+//    numbers to match, and the walk below follows the same order.
+//  * GEPs with constant indices only hash their base pointer: cmpGEPs compares
+//    their offsets, which depend on DataLayout queries that are not safe to
+//    make concurrently.
+class FunctionFingerprinter {
+  enum : uint64_t {
+    SelfReference = 0x1e85b3a9c4f0d267ULL,
+    NullValue = 0x5b1c2e7f0a9d3846ULL,
+    LocalValue = 0x2f6a94d1b87c05e3ULL,
+    InlineAsmValue = 0x7d03c8e5a16f924bULL,
+    ConstantOffsetGEP = 0x4c9e17b2d05a3f68ULL,
+  };
+
+  const Function &F;
+  unsigned PointerSizeInBits;
+  HashAccumulator64 H;
+  DenseMap<const Value *, unsigned> Numbers;
+  DenseMap<Type *, uint64_t> TypeHashes;
+
+  uint64_t hashType(Type *Ty);
+  void addType(Type *Ty) { H.add(hashType(Ty)); }
+  void addValue(const Value *V);
+  void addConstant(const Constant *C);
+  void addInstruction(const Instruction &I);
+
+public:
+  explicit FunctionFingerprinter(const Function &F)
+      : F(F),
+        PointerSizeInBits(
+            F.getParent()->getDataLayout().getPointerSizeInBits(0)) {}
+
+  FunctionComparator::FunctionHash run();
+};
+
+} // end anonymous namespace
+
+uint64_t FunctionFingerprinter::hashType(Type *Ty) {
+  auto It = TypeHashes.find(Ty);
+  if (It != TypeHashes.end())
+    return It->second;
+
+  hash_code Hash;
+  auto *PTy = dyn_cast<PointerType>(Ty);
+  if (PTy && PTy->getAddressSpace() == 0) {
+    Hash = hash_combine(unsigned(Type::IntegerTyID), PointerSizeInBits);
+  } else {
+    switch (Ty->getTypeID()) {
+    case Type::IntegerTyID:
+      Hash = hash_combine(unsigned(Type::IntegerTyID),
+                          cast<IntegerType>(Ty)->getBitWidth());
+      break;
+    case Type::PointerTyID:
+      Hash = hash_combine(unsigned(Type::PointerTyID), PTy->getAddressSpace());
+      break;
+    case Type::StructTyID: {
+      auto *STy = cast<StructType>(Ty);
+      Hash = hash_combine(unsigned(Type::StructTyID), STy->getNumElements(),
+                          STy->isPacked());
+      for (Type *ElTy : STy->elements())
+        Hash = hash_combine(Hash, hashType(ElTy));
+      break;
+    }
+    case Type::FunctionTyID: {
+      auto *FTy = cast<FunctionType>(Ty);
+      Hash = hash_combine(unsigned(Type::FunctionTyID), FTy->getNumParams(),
+                          FTy->isVarArg(), hashType(FTy->getReturnType()));
+      for (Type *ParamTy : FTy->params())
+        Hash = hash_combine(Hash, hashType(ParamTy));
+      break;
+    }
+    case Type::ArrayTyID:
+    case Type::VectorTyID: {
+      auto *STy = cast<SequentialType>(Ty);
+      Hash = hash_combine(unsigned(Ty->getTypeID()), STy->getNumElements(),
+                          hashType(STy->getElementType()));
+      break;
+    }
+    default:
+      Hash = hash_value(unsigned(Ty->getTypeID()));
+      break;
+    }
+  }
+  return TypeHashes[Ty] = Hash;
+}
+
+void FunctionFingerprinter::addValue(const Value *V) {
+  if (V == &F) {
+    H.add(SelfReference);
+    return;
+  }
+  if (auto *C = dyn_cast<Constant>(V)) {
+    addConstant(C);
+    return;
+  }
+  if (auto *IA = dyn_cast<InlineAsm>(V)) {
+    H.add(InlineAsmValue);
+    H.add(hash_combine(IA->getAsmString(), IA->getConstraintString()));
+    return;
+  }
+  H.add(LocalValue);
+  H.add(Numbers.insert({V, Numbers.size()}).first->second);
+}
+
+void FunctionFingerprinter::addConstant(const Constant *C) {
+  if (C->isNullValue()) {
+    H.add(NullValue);
+    return;
+  }
+  if (auto *GV = dyn_cast<GlobalValue>(C)) {
+    H.add(hash_value(GV->getName()));
+    return;
+  }
+  H.add(C->getValueID());
+  if (auto *CI = dyn_cast<ConstantInt>(C)) {
+    H.add(hash_value(CI->getValue()));
+  } else if (auto *CFP = dyn_cast<ConstantFP>(C)) {
+    H.add(hash_value(CFP->getValueAPF()));
+  } else if (auto *CDS = dyn_cast<ConstantDataSequential>(C)) {
+    H.add(hash_value(CDS->getRawDataValues()));
+  } else if (auto *BA = dyn_cast<BlockAddress>(C)) {
+    // cmpConstants only numbers the block if it is one of the compared
+    // functions'.
+    if (BA->getFunction() == &F)
+      addValue(BA->getBasicBlock());
+    else
+      addConstant(BA->getFunction());
+  }
+}
+
+void FunctionFingerprinter::addInstruction(const Instruction &I) {
+  // cmpOperations numbers the instruction before anything else.
+  addValue(&I);
+  H.add(I.getOpcode());
+
+  if (auto *GEP = dyn_cast<GetElementPtrInst>(&I)) {
+    addValue(GEP->getPointerOperand());
+    H.add(GEP->getPointerAddressSpace());
+    if (all_of(GEP->indices(),
+               [](const Use &Idx) { return isa<ConstantInt>(Idx); })) {
+      H.add(ConstantOffsetGEP);
+      return;
+    }
+    addType(GEP->getSourceElementType());
+    H.add(GEP->getNumOperands());
+    for (const Value *Op : GEP->operands())
+      addValue(Op);
+    return;
+  }
+
+  H.add(I.getNumOperands());
+  addType(I.getType());
+  H.add(I.getRawSubclassOptionalData());
+  for (const Value *Op : I.operands())
+    addType(Op->getType());
+
+  if (auto *AI = dyn_cast<AllocaInst>(&I)) {
+    addType(AI->getAllocatedType());
+    H.add(AI->getAlignment());
+  } else if (auto *LI = dyn_cast<LoadInst>(&I)) {
+    H.add(LI->isVolatile());
+    H.add(LI->getAlignment());
+    H.add(uint64_t(LI->getOrdering()));
+    H.add(LI->getSyncScopeID());
+  } else if (auto *SI = dyn_cast<StoreInst>(&I)) {
+    H.add(SI->isVolatile());
+    H.add(SI->getAlignment());
+    H.add(uint64_t(SI->getOrdering()));
+    H.add(SI->getSyncScopeID());
+  } else if (auto *CI = dyn_cast<CmpInst>(&I)) {
+    H.add(CI->getPredicate());
+  } else if (auto CS = ImmutableCallSite(&I)) {
+    H.add(CS.getCallingConv());
+  } else if (auto *IVI = dyn_cast<InsertValueInst>(&I)) {
+    H.add(hash_combine_range(IVI->idx_begin(), IVI->idx_end()));
+  } else if (auto *EVI = dyn_cast<ExtractValueInst>(&I)) {
+    H.add(hash_combine_range(EVI->idx_begin(), EVI->idx_end()));
+  } else if (auto *FI = dyn_cast<FenceInst>(&I)) {
+    H.add(uint64_t(FI->getOrdering()));
+    H.add(FI->getSyncScopeID());
+  } else if (auto *CXI = dyn_cast<AtomicCmpXchgInst>(&I)) {
+    H.add(CXI->isVolatile());
+    H.add(CXI->isWeak());
+    H.add(uint64_t(CXI->getSuccessOrdering()));
+    H.add(uint64_t(CXI->getFailureOrdering()));
+    H.add(CXI->getSyncScopeID());
+  } else if (auto *RMWI = dyn_cast<AtomicRMWInst>(&I)) {
+    H.add(RMWI->getOperation());
+    H.add(RMWI->isVolatile());
+    H.add(uint64_t(RMWI->getOrdering()));
+    H.add(RMWI->getSyncScopeID());
+  } else if (auto *PN = dyn_cast<PHINode>(&I)) {
+    for (const BasicBlock *BB : PN->blocks())
+      addValue(BB);
+  }
+
+  for (const Value *Op : I.operands())
+    addValue(Op);
+}
+
+FunctionComparator::FunctionHash FunctionFingerprinter::run() {
+  H.add(F.hasGC());
+  if (F.hasGC())
+    H.add(hash_value(F.getGC()));
+  H.add(F.hasSection());
+  if (F.hasSection())
+    H.add(hash_value(F.getSection()));
+  H.add(F.isVarArg());
+  H.add(F.getCallingConv());
+  addType(F.getFunctionType());
+  for (const Argument &Arg : F.args())
+    addValue(&Arg);
+
+  SmallVector<const BasicBlock *, 8> BBs;
+  SmallPtrSet<const BasicBlock *, 16> VisitedBBs;
+
+  // Walk the blocks in the same order as compare().
+  BBs.push_back(&F.getEntryBlock());
+  VisitedBBs.insert(BBs[0]);
+  while (!BBs.empty()) {
+    const BasicBlock *BB = BBs.pop_back_val();
+    addValue(BB);
+    for (const Instruction &Inst : *BB)
+      addInstruction(Inst);
+    const TerminatorInst *Term = BB->getTerminator();
+    for (unsigned i = 0, e = Term->getNumSuccessors(); i != e; ++i) {
+      if (!VisitedBBs.insert(Term->getSuccessor(i)).second)
+        continue;
+      BBs.push_back(Term->getSuccessor(i));
+    }
+  }
+  return H.getHash();
+}
+
+FunctionComparator::FunctionHash
+FunctionComparator::functionFingerprint(Function &F) {
+  return FunctionFingerprinter(F).run();
+}
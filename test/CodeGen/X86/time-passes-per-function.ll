@@ -0,0 +1,32 @@
+; RUN: llc < %s -mtriple=x86_64-unknown-unknown -time-passes-per-function=%t -o /dev/null
+; RUN: FileCheck %s < %t
+
+; Every function gets its own list of per-pass records. IR passes report IR
+; instruction counts; machine function passes also report machine
+; instruction counts.
+
+; CHECK:      "functions": [
+; CHECK:          "name": "foo",
+; CHECK-NEXT:     "passes": [
+; CHECK:              "instrs_after": 3,
+; CHECK-NEXT:         "instrs_before": 3,
+; CHECK-NEXT:         "malloc_bytes": {{-?[0-9]+}},
+; CHECK:              "pass": "codegenprepare",
+; CHECK-NEXT:         "user_time": {{[0-9.e+-]+}},
+; CHECK-NEXT:         "wall_time": {{[0-9.e+-]+}}
+; CHECK:              "machine_instrs_after": {{[0-9]+}},
+; CHECK-NEXT:         "machine_instrs_before": {{[0-9]+}},
+; CHECK:              "pass": "prologepilog",
+; CHECK:          "wall_time": {{[0-9.e+-]+}}
+; CHECK:          "name": "bar",
+; CHECK:              "pass": "prologepilog",
+
+define i32 @foo(i32 %a, i32 %b) {
+  %sum = add i32 %a, %b
+  %res = call i32 @bar(i32 %sum)
+  ret i32 %res
+}
+
+define i32 @bar(i32 %x) {
+  ret i32 %x
+}
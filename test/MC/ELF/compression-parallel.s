@@ -0,0 +1,25 @@
+// REQUIRES: zlib
+// Compressing the debug sections concurrently must not change the output.
+// RUN: llvm-mc -filetype=obj -compress-debug-sections=zlib -triple x86_64-pc-linux-gnu %s -o %t.par
+// RUN: llvm-mc -filetype=obj -compress-debug-sections=zlib -triple x86_64-pc-linux-gnu %s -o %t.seq \
+// RUN:     -elf-parallel-compress-debug-sections=false
+// RUN: cmp %t.par %t.seq
+// RUN: llvm-mc -filetype=obj -compress-debug-sections=zlib-gnu -triple x86_64-pc-linux-gnu %s -o %t.par
+// RUN: llvm-mc -filetype=obj -compress-debug-sections=zlib-gnu -triple x86_64-pc-linux-gnu %s -o %t.seq \
+// RUN:     -elf-parallel-compress-debug-sections=false
+// RUN: cmp %t.par %t.seq
+// RUN: llvm-readobj -sections %t.par | FileCheck %s
+
+// CHECK: Name: .zdebug_str
+// CHECK: Name: .zdebug_info
+
+	.section	.debug_str,"MS",@progbits,1
+	.rept	64
+	.asciz	"a fairly repetitive debug string that compresses well"
+	.endr
+
+	.section	.debug_info,"",@progbits
+	.rept	64
+	.long	0x12345678
+	.long	0x9abcdef0
+	.endr
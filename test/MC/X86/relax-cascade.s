@@ -0,0 +1,21 @@
+# RUN: llvm-mc -filetype=obj -triple=x86_64-unknown-unknown %s -o %t
+# RUN: llvm-objdump -d %t | FileCheck %s
+
+# The second jump is out of range and is relaxed in the first layout
+# iteration. That pushes the target of the first jump out of range too, so it
+# has to be examined again and relaxed in the next iteration.
+
+	.text
+	.globl	foo
+foo:
+	jmp	.Lfar1
+	.fill	123, 1, 0x90
+	jmp	.Lfar2
+.Lfar1:
+	.fill	200, 1, 0x90
+.Lfar2:
+	retq
+
+# CHECK-LABEL: foo:
+# CHECK-NEXT: 0: e9 80 00 00 00 jmp
+# CHECK: 80: e9 c8 00 00 00 jmp
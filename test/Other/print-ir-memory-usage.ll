@@ -0,0 +1,33 @@
+; RUN: opt -print-ir-memory-usage -instcombine -disable-output < %s 2>&1 | FileCheck %s
+; RUN: opt -print-ir-memory-usage -passes=instcombine -disable-output < %s 2>&1 | FileCheck %s
+
+; The byte counts depend on the host, so only the object counts are checked.
+
+; CHECK:      ... IR Memory Usage (input) ...
+; CHECK:      Count Bytes Kind
+; CHECK-DAG:  {{^ +}}3 {{[0-9]+}} add{{$}}
+; CHECK-DAG:  {{^ +}}1 {{[0-9]+}} load{{$}}
+; CHECK-DAG:  {{^ +}}1 {{[0-9]+}} ret{{$}}
+; CHECK-DAG:  {{^ +}}2 {{[0-9]+}} Argument{{$}}
+; CHECK-DAG:  {{^ +}}1 {{[0-9]+}} BasicBlock{{$}}
+; CHECK-DAG:  {{^ +}}3 {{[0-9]+}} ConstantInt{{$}}
+; CHECK-DAG:  {{^ +}}1 {{[0-9]+}} Function{{$}}
+; CHECK-DAG:  {{^ +}}1 {{[0-9]+}} GlobalVariable{{$}}
+; CHECK-DAG:  {{^ +}}9 {{[0-9]+}} Use{{$}}
+; CHECK:      {{^ +}}{{[0-9]+}} Total{{$}}
+; CHECK:      {{^ +}}{{[0-9]+}} Process malloc usage{{$}}
+
+; CHECK:      ... IR Memory Usage (output) ...
+; CHECK-DAG:  {{^ +}}2 {{[0-9]+}} add{{$}}
+; CHECK-DAG:  {{^ +}}1 {{[0-9]+}} load{{$}}
+; CHECK:      {{^ +}}{{[0-9]+}} Total{{$}}
+
+@g = global i32 7
+
+define i32 @f(i32 %a, i32 %b) {
+  %v = load i32, i32* @g
+  %x = add i32 %a, 1
+  %y = add i32 %x, 2
+  %z = add i32 %y, %v
+  ret i32 %z
+}
@@ -0,0 +1,54 @@
+; RUN: llvm-as < %s > %t.bc
+; RUN: opt -stream-function-bodies -analyze -domtree %t.bc | FileCheck %s --check-prefix=ANALYZE
+; RUN: opt -stream-function-bodies -instcombine -disable-output \
+; RUN:   -print-ir-memory-usage %t.bc 2>&1 | FileCheck %s --check-prefix=MEMORY
+; RUN: opt -stream-function-bodies -analyze -scalar-evolution -data-layout=i32:8:8 \
+; RUN:   %t.bc | FileCheck %s --check-prefix=LAYOUT
+; RUN: not opt -stream-function-bodies -instcombine %t.bc -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=OUTPUT
+; RUN: not opt -stream-function-bodies -globaldce -disable-output %t.bc 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=MODULE-PASS
+
+; Every body is read and analyzed in turn.
+; ANALYZE: Printing analysis 'Dominator Tree Construction' for function 'f':
+; ANALYZE: Printing analysis 'Dominator Tree Construction' for function 'g':
+
+; Functions are only read when the passes reach them, and are deleted after.
+; MEMORY:      ... IR Memory Usage (input) ...
+; MEMORY-NOT:  BasicBlock
+; MEMORY:      Total
+; MEMORY:      ... IR Memory Usage (output) ...
+; MEMORY-NOT:  BasicBlock
+; MEMORY:      Total
+
+; -data-layout applies to the lazily loaded module too: i32 is byte aligned.
+; LAYOUT: Classifying expressions for: @h
+; LAYOUT: %q = getelementptr
+; LAYOUT-NEXT: --> (1 + %p)
+
+; OUTPUT: -stream-function-bodies requires -disable-output or -analyze.
+
+; MODULE-PASS: -stream-function-bodies cannot run pass 'globaldce'
+
+$f = comdat any
+
+define linkonce_odr i32 @f(i32 %a) comdat {
+entry:
+  %b = add i32 %a, 0
+  br label %exit
+
+exit:
+  ret i32 %b
+}
+
+define internal i32 @g(i32 %a) {
+  %b = call i32 @f(i32 %a)
+  ret i32 %b
+}
+
+%pair = type { i8, i32 }
+
+define i32* @h(%pair* %p) {
+  %q = getelementptr %pair, %pair* %p, i64 0, i32 1
+  ret i32* %q
+}
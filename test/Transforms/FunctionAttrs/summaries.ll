@@ -0,0 +1,141 @@
+; RUN: opt < %s -summary-functionattrs -S | FileCheck %s
+; RUN: opt < %s -passes=summary-function-attrs -S | FileCheck %s
+; RUN: opt < %s -aa-pipeline=basic-aa -passes='cgscc(function-attrs)' -function-attrs-use-summaries -S | FileCheck %s
+
+@g = global i32 0
+@c = constant i32 1
+
+declare void @ext()
+
+; CHECK: Function Attrs
+; CHECK-SAME: norecurse nounwind readnone
+; CHECK-NEXT: define i32 @leaf()
+define i32 @leaf() {
+  ret i32 1
+}
+
+; Loads and stores of local and constant memory are ignored.
+; CHECK: Function Attrs
+; CHECK-SAME: norecurse nounwind readnone
+; CHECK-NEXT: define i32 @local(i1 %b)
+define i32 @local(i1 %b) {
+  %a1 = alloca i32
+  %a2 = alloca i32
+  %p = select i1 %b, i32* %a1, i32* %a2
+  store i32 1, i32* %p
+  %v = load i32, i32* %p
+  %w = load i32, i32* @c
+  %r = add i32 %v, %w
+  ret i32 %r
+}
+
+; CHECK: Function Attrs
+; CHECK-SAME: norecurse nounwind readonly
+; CHECK-NEXT: define i32 @reads_global()
+define i32 @reads_global() {
+  %v = load i32, i32* @g
+  ret i32 %v
+}
+
+; CHECK: Function Attrs
+; CHECK-SAME: norecurse nounwind writeonly
+; CHECK-NEXT: define void @writes_global()
+define void @writes_global() {
+  store i32 0, i32* @g
+  ret void
+}
+
+; The callees are summarized before their attributes are known.
+; CHECK: Function Attrs
+; CHECK-SAME: norecurse nounwind readonly
+; CHECK-NEXT: define i32 @calls_reads_global()
+define i32 @calls_reads_global() {
+  %v = call i32 @reads_global()
+  ret i32 %v
+}
+
+; CHECK: Function Attrs
+; CHECK-SAME: nounwind readonly
+; CHECK-NOT: norecurse
+; CHECK-NEXT: define i32 @mutual1(i32 %n)
+define i32 @mutual1(i32 %n) {
+  %v = load i32, i32* @g
+  %c = icmp eq i32 %n, 0
+  br i1 %c, label %exit, label %rec
+
+rec:
+  %m = sub i32 %n, 1
+  %r = call i32 @mutual2(i32 %m)
+  br label %exit
+
+exit:
+  %p = phi i32 [ %v, %0 ], [ %r, %rec ]
+  ret i32 %p
+}
+
+; CHECK: Function Attrs
+; CHECK-SAME: nounwind readonly
+; CHECK-NOT: norecurse
+; CHECK-NEXT: define i32 @mutual2(i32 %n)
+define i32 @mutual2(i32 %n) {
+  %r = call i32 @mutual1(i32 %n)
+  ret i32 %r
+}
+
+; CHECK: define void @calls_ext()
+; CHECK-NOT: Function Attrs
+define void @calls_ext() {
+  call void @ext()
+  ret void
+}
+
+; Indirect calls block nounwind and norecurse.
+; CHECK: Function Attrs
+; CHECK-SAME: readnone
+; CHECK-NOT: nounwind
+; CHECK-NEXT: define void @indirect(void ()* nocapture %f)
+define void @indirect(void ()* %f) {
+  call void %f() readnone
+  ret void
+}
+
+; CHECK: define i32 @use(i32* nocapture %p)
+define i32 @use(i32* %p) {
+  %v = load i32, i32* %p
+  ret i32 %v
+}
+
+; CHECK: define i32 @pass_through(i32* nocapture %p)
+define i32 @pass_through(i32* %p) {
+  %v = call i32 @use(i32* %p)
+  ret i32 %v
+}
+
+; CHECK: define void @escape(i32* %p)
+define void @escape(i32* %p) {
+  %i = ptrtoint i32* %p to i32
+  store i32 %i, i32* @g
+  ret void
+}
+
+; CHECK: define void @calls_escape(i32* %p)
+define void @calls_escape(i32* %p) {
+  call void @escape(i32* %p)
+  ret void
+}
+
+; Arguments passed around within an SCC are not captured if nothing else
+; captures them.
+; CHECK: define void @arg_rec1(i32* nocapture %p, i32* %q)
+define void @arg_rec1(i32* %p, i32* %q) {
+  store i32 0, i32* @g
+  call void @arg_rec2(i32* %p, i32* %q)
+  ret void
+}
+
+; CHECK: define void @arg_rec2(i32* nocapture %p, i32* %q)
+define void @arg_rec2(i32* %p, i32* %q) {
+  call void @arg_rec1(i32* %p, i32* %q)
+  call void @escape(i32* %q)
+  ret void
+}
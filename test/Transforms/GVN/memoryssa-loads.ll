@@ -0,0 +1,113 @@
+; RUN: opt < %s -basicaa -gvn -S | FileCheck %s
+; RUN: opt < %s -basicaa -gvn -enable-gvn-memoryssa -S | FileCheck %s
+; RUN: opt < %s -basicaa -gvn -enable-gvn-memoryssa -memssa-check-limit=0 -S | FileCheck %s
+
+; Load elimination should give the same results whether the dependencies of
+; loads come from memdep or MemorySSA, including for the loads MemorySSA did
+; not optimize and GVN hands back to memdep.
+
+; Store to load forwarding in the same block.
+define i32 @store_forward(i32* %p, i32 %v) {
+; CHECK-LABEL: @store_forward(
+; CHECK-NEXT:    store i32 %v, i32* %p
+; CHECK-NEXT:    ret i32 %v
+  store i32 %v, i32* %p
+  %a = load i32, i32* %p
+  ret i32 %a
+}
+
+; A load made redundant by an earlier load, across an unrelated store.
+define i32 @load_load(i32* noalias %p, i32* noalias %q) {
+; CHECK-LABEL: @load_load(
+; CHECK-NEXT:    %a = load i32, i32* %p
+; CHECK-NEXT:    store i32 0, i32* %q
+; CHECK-NEXT:    %c = add i32 %a, %a
+; CHECK-NEXT:    ret i32 %c
+  %a = load i32, i32* %p
+  store i32 0, i32* %q
+  %b = load i32, i32* %p
+  %c = add i32 %a, %b
+  ret i32 %c
+}
+
+; A load made redundant by a load in a dominating block.
+define i32 @dominating_load(i32* %p, i1 %c) {
+; CHECK-LABEL: @dominating_load(
+; CHECK:       entry:
+; CHECK-NEXT:    %a = load i32, i32* %p
+; CHECK:       then:
+; CHECK-NEXT:    ret i32 %a
+; CHECK:       else:
+; CHECK-NEXT:    %r = add i32 %a, 1
+; CHECK-NEXT:    ret i32 %r
+entry:
+  %a = load i32, i32* %p
+  br i1 %c, label %then, label %else
+
+then:
+  %b = load i32, i32* %p
+  ret i32 %b
+
+else:
+  %r = add i32 %a, 1
+  ret i32 %r
+}
+
+; A store in a dominating block forwards its value.
+define i32 @dominating_store(i32* %p, i32 %v, i1 %c) {
+; CHECK-LABEL: @dominating_store(
+; CHECK:       then:
+; CHECK-NEXT:    ret i32 %v
+entry:
+  store i32 %v, i32* %p
+  br i1 %c, label %then, label %else
+
+then:
+  %b = load i32, i32* %p
+  ret i32 %b
+
+else:
+  ret i32 0
+}
+
+; A store that may alias blocks elimination.
+define i32 @may_alias(i32* %p, i32* %q) {
+; CHECK-LABEL: @may_alias(
+; CHECK-NEXT:    %a = load i32, i32* %p
+; CHECK-NEXT:    store i32 0, i32* %q
+; CHECK-NEXT:    %b = load i32, i32* %p
+  %a = load i32, i32* %p
+  store i32 0, i32* %q
+  %b = load i32, i32* %p
+  %c = add i32 %a, %b
+  ret i32 %c
+}
+
+; The load is only partially redundant; load PRE still applies.
+define i32 @partial(i32* %p, i1 %c) {
+; CHECK-LABEL: @partial(
+; CHECK:       then:
+; CHECK-NEXT:    %a = load i32, i32* %p
+; CHECK:       else:
+; CHECK-NEXT:    [[PRE:%.*]] = load i32, i32* %p
+; CHECK:       merge:
+; CHECK-NEXT:    [[B:%.*]] = phi i32 [ %a, %then ], [ [[PRE]], %else ]
+; CHECK-NEXT:    %x = phi i32 [ %a, %then ], [ 0, %else ]
+; CHECK-NEXT:    %r = add i32 %x, [[B]]
+; CHECK-NEXT:    ret i32 %r
+entry:
+  br i1 %c, label %then, label %else
+
+then:
+  %a = load i32, i32* %p
+  br label %merge
+
+else:
+  br label %merge
+
+merge:
+  %x = phi i32 [ %a, %then ], [ 0, %else ]
+  %b = load i32, i32* %p
+  %r = add i32 %x, %b
+  ret i32 %r
+}
@@ -0,0 +1,67 @@
+; RUN: opt -inline -inline-threshold=20 -S < %s | FileCheck %s
+; RUN: opt -inline -inline-cost-summaries -inline-threshold=20 -S < %s | FileCheck %s
+; RUN: opt -passes='cgscc(inline)' -inline-cost-summaries -inline-threshold=20 -S < %s | FileCheck %s
+; RUN: opt -inline -inline-cost-summaries -inline-threshold=20 -stats -disable-output < %s 2>&1 | FileCheck %s --check-prefix=STATS
+; RUN: opt -passes='cgscc(inline)' -inline-cost-summaries -inline-threshold=20 -stats -disable-output < %s 2>&1 | FileCheck %s --check-prefix=STATS
+; REQUIRES: asserts
+
+; The analysis of @popular is reused for the call sites that pass the same
+; constant for %k, and for those that pass no constant, and must make the same
+; decisions as when it is done for each call site.
+
+; STATS: 3 inline-cost{{.*}}Number of call sites analyzed from a summary of the callee
+
+define i32 @popular(i32 %k, i32 %x) {
+entry:
+  %c = icmp eq i32 %k, 0
+  br i1 %c, label %cheap, label %expensive
+
+cheap:
+  ret i32 %x
+
+expensive:
+  %a1 = mul i32 %x, %x
+  %a2 = mul i32 %a1, %x
+  %a3 = mul i32 %a2, %x
+  %a4 = mul i32 %a3, %x
+  %a5 = mul i32 %a4, %x
+  %a6 = mul i32 %a5, %x
+  %a7 = mul i32 %a6, %x
+  %a8 = mul i32 %a7, %x
+  %a9 = mul i32 %a8, %x
+  %a10 = mul i32 %a9, %x
+  %a11 = mul i32 %a10, %x
+  %a12 = mul i32 %a11, %x
+  %a13 = mul i32 %a12, %x
+  %a14 = mul i32 %a13, %x
+  %a15 = mul i32 %a14, %x
+  %a16 = mul i32 %a15, %x
+  ret i32 %a16
+}
+
+define i32 @constant1(i32 %x) {
+; CHECK-LABEL: @constant1(
+; CHECK-NOT: call
+; CHECK: ret i32
+  %r1 = call i32 @popular(i32 0, i32 %x)
+  %r2 = call i32 @popular(i32 0, i32 %r1)
+  ret i32 %r2
+}
+
+define i32 @variable(i32 %k, i32 %x) {
+; CHECK-LABEL: @variable(
+; CHECK: call i32 @popular(i32 %k, i32 %x)
+; CHECK: call i32 @popular(i32 %k, i32 %r1)
+; CHECK: ret i32
+  %r1 = call i32 @popular(i32 %k, i32 %x)
+  %r2 = call i32 @popular(i32 %k, i32 %r1)
+  ret i32 %r2
+}
+
+define i32 @constant2(i32 %x) {
+; CHECK-LABEL: @constant2(
+; CHECK-NOT: call
+; CHECK: ret i32 %x
+  %r = call i32 @popular(i32 0, i32 %x)
+  ret i32 %r
+}
@@ -0,0 +1,61 @@
+; RUN: opt -mergefunc -S < %s | FileCheck %s
+target datalayout = "e-p:64:64:64-i32:32:32-i64:64:64-n8:16:32:64-S128"
+
+; The fingerprint of a function does not cover the offsets of GEPs with
+; constant indices, so all these functions share one. Only those that load
+; from the same offsets are equal, and each must be merged with its own kind.
+; The functions merged away are replaced by thunks at the end of the module.
+
+; CHECK-LABEL: define i32 @b1(
+; CHECK-NEXT: getelementptr inbounds i32, i32* %p, i64 3
+; CHECK-LABEL: define i32 @c1(
+; CHECK-NEXT: getelementptr inbounds i32, i32* %p, i64 5
+; CHECK-LABEL: define i32 @a2(
+; CHECK-NEXT: tail call i32 @a1(
+; CHECK-LABEL: define i32 @b2(
+; CHECK-NEXT: tail call i32 @b1(
+
+define i32 @a1(i32* %p) {
+  %g1 = getelementptr inbounds i32, i32* %p, i64 1
+  %v1 = load i32, i32* %g1
+  %g2 = getelementptr inbounds i32, i32* %p, i64 2
+  %v2 = load i32, i32* %g2
+  %r = add i32 %v1, %v2
+  ret i32 %r
+}
+
+define i32 @b1(i32* %p) {
+  %g1 = getelementptr inbounds i32, i32* %p, i64 3
+  %v1 = load i32, i32* %g1
+  %g2 = getelementptr inbounds i32, i32* %p, i64 4
+  %v2 = load i32, i32* %g2
+  %r = add i32 %v1, %v2
+  ret i32 %r
+}
+
+define i32 @a2(i32* %p) {
+  %g1 = getelementptr inbounds i32, i32* %p, i64 1
+  %v1 = load i32, i32* %g1
+  %g2 = getelementptr inbounds i32, i32* %p, i64 2
+  %v2 = load i32, i32* %g2
+  %r = add i32 %v1, %v2
+  ret i32 %r
+}
+
+define i32 @c1(i32* %p) {
+  %g1 = getelementptr inbounds i32, i32* %p, i64 5
+  %v1 = load i32, i32* %g1
+  %g2 = getelementptr inbounds i32, i32* %p, i64 6
+  %v2 = load i32, i32* %g2
+  %r = add i32 %v1, %v2
+  ret i32 %r
+}
+
+define i32 @b2(i32* %p) {
+  %g1 = getelementptr inbounds i32, i32* %p, i64 3
+  %v1 = load i32, i32* %g1
+  %g2 = getelementptr inbounds i32, i32* %p, i64 4
+  %v2 = load i32, i32* %g2
+  %r = add i32 %v1, %v2
+  ret i32 %r
+}
@@ -0,0 +1,19 @@
+# RUN: llvm-mc %s -filetype=obj -triple=x86_64-pc-linux -o %t
+
+# RUN: llvm-objdump -d %t | FileCheck %s
+# CHECK:      callq {{.*}} <foo>
+# CHECK-NEXT: jmp {{.*}} <foo>
+
+## Branch targets are not resolved to symbols with -no-symbolize.
+# RUN: llvm-objdump -d -no-symbolize %t | FileCheck %s --check-prefix=NOSYM
+# NOSYM:      callq
+# NOSYM-NOT:  <foo
+# NOSYM:      jmp
+# NOSYM-NOT:  <foo
+
+.text
+foo:
+  nop
+bar:
+  callq foo
+  jmp foo
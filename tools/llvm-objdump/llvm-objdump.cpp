@@ -108,6 +108,11 @@ static StringSet<> DisasmFuncsSet;
 cl::opt<bool>
 llvm::Relocations("r", cl::desc("Display the relocation entries in the file"));
 
+static cl::opt<bool>
+NoSymbolize("no-symbolize",
+            cl::desc("Do not resolve branch targets and operands to symbol "
+                     "names when disassembling; faster on large binaries"));
+
 cl::opt<bool>
 llvm::DynamicRelocations("dynamic-reloc",
   cl::desc("Display the dynamic relocation entries in the file"));
@@ -1419,6 +1424,11 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
     array_pod_sort(SecSyms.second.begin(), SecSyms.second.end());
   array_pod_sort(AbsoluteSymbols.begin(), AbsoluteSymbols.end());
 
+  // Properties of the object checked for every instruction below.
+  const bool IsArmElf = isArmElf(Obj);
+  const bool IsRelocatable = Obj->isRelocatableObject();
+  const bool IsHexagon = Obj->getArch() == Triple::hexagon;
+
   for (const SectionRef &Section : ToolSectionFilter(*Obj)) {
     if (!DisassembleAll && (!Section.isText() || Section.isVirtual()))
       continue;
@@ -1432,7 +1442,7 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
     SectionSymbolsTy &Symbols = AllSymbols[Section];
     std::vector<uint64_t> DataMappingSymsAddr;
     std::vector<uint64_t> TextMappingSymsAddr;
-    if (isArmElf(Obj)) {
+    if (IsArmElf) {
       for (const auto &Symb : Symbols) {
         uint64_t Address = std::get<0>(Symb);
         StringRef Name = std::get<1>(Symb);
@@ -1450,7 +1460,7 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
     llvm::sort(DataMappingSymsAddr.begin(), DataMappingSymsAddr.end());
     llvm::sort(TextMappingSymsAddr.begin(), TextMappingSymsAddr.end());
 
-    if (Obj->isELF() && Obj->getArch() == Triple::amdgcn) {
+    if (Obj->isELF() && Obj->getArch() == Triple::amdgcn && !NoSymbolize) {
       // AMDGPU disassembler uses symbolizer for printing labels
       std::unique_ptr<MCRelocationInfo> RelInfo(
         TheTarget->createMCRelocationInfo(TripleName, Ctx));
@@ -1611,7 +1621,7 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
         // same section. We rely on the markers introduced to
         // understand what we need to dump. If the data marker is within a
         // function, it is denoted as a word/short etc
-        if (isArmElf(Obj) && std::get<2>(Symbols[si]) != ELF::STT_OBJECT &&
+        if (IsArmElf && std::get<2>(Symbols[si]) != ELF::STT_OBJECT &&
             !DisassembleAll) {
           uint64_t Stride = 0;
 
@@ -1732,8 +1742,9 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
 
         // Try to resolve the target of a call, tail call, etc. to a specific
         // symbol.
-        if (MIA && (MIA->isCall(Inst) || MIA->isUnconditionalBranch(Inst) ||
-                    MIA->isConditionalBranch(Inst))) {
+        if (MIA && !NoSymbolize &&
+            (MIA->isCall(Inst) || MIA->isUnconditionalBranch(Inst) ||
+             MIA->isConditionalBranch(Inst))) {
           uint64_t Target;
           if (MIA->evaluateBranch(Inst, SectionAddr + Index, Size, Target)) {
             // In a relocatable object, the target's section must reside in
@@ -1744,7 +1755,7 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
             //
             // N.B. We don't walk the relocations in the relocatable case yet.
             auto *TargetSectionSymbols = &Symbols;
-            if (!Obj->isRelocatableObject()) {
+            if (!IsRelocatable) {
               auto SectionAddress = std::upper_bound(
                   SectionAddresses.begin(), SectionAddresses.end(), Target,
                   [](uint64_t LHS,
@@ -1792,7 +1803,7 @@ static void DisassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
         outs() << "\n";
 
         // Hexagon does this in pretty printer
-        if (Obj->getArch() != Triple::hexagon)
+        if (!IsHexagon)
           // Print relocation for instruction.
           while (rel_cur != rel_end) {
             bool hidden = getHidden(*rel_cur);
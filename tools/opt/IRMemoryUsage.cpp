@@ -0,0 +1,168 @@
+//===- IRMemoryUsage.cpp - In-memory IR footprint report ------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Report how much memory the in-memory IR of a module occupies, broken down
+/// by value class.
+///
+/// The byte counts are estimates computed from the sizes of the C++ classes
+/// and of the Use arrays attached to them; allocator overhead, names,
+/// metadata and the uniquing tables of the context are not included. The
+/// malloc usage of the whole process is printed next to them for comparison.
+///
+/// This is only groundwork for a more compact IR representation: it gives the
+/// baseline to measure such a change against, and shows which classes it
+/// should target first. It does not change how IR is stored.
+///
+//===----------------------------------------------------------------------===//
+#include "IRMemoryUsage.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalAlias.h"
+#include "llvm/IR/GlobalIFunc.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+
+using namespace llvm;
+
+namespace {
+
+struct UsageEntry {
+  uint64_t Count = 0;
+  uint64_t Bytes = 0;
+};
+
+class IRMemoryUsage {
+  StringMap<UsageEntry> Entries;
+  SmallPtrSet<const Constant *, 32> VisitedConstants;
+  SmallVector<const Constant *, 16> ConstantWorklist;
+
+  void add(StringRef Kind, uint64_t Count, uint64_t Bytes) {
+    UsageEntry &E = Entries[Kind];
+    E.Count += Count;
+    E.Bytes += Bytes;
+  }
+
+  void addUses(const User &U) {
+    add("Use", U.getNumOperands(), U.getNumOperands() * sizeof(Use));
+    for (const Value *Op : U.operands())
+      if (auto *C = dyn_cast<Constant>(Op))
+        if (VisitedConstants.insert(C).second)
+          ConstantWorklist.push_back(C);
+  }
+
+  void addInstruction(const Instruction &I);
+  void addConstant(const Constant &C);
+
+public:
+  explicit IRMemoryUsage(const Module &M);
+
+  void print(StringRef When, raw_ostream &OS) const;
+};
+
+} // end anonymous namespace
+
+void IRMemoryUsage::addInstruction(const Instruction &I) {
+  size_t Size;
+  switch (I.getOpcode()) {
+#define HANDLE_INST(N, OPC, CLASS)                                             \
+  case Instruction::OPC:                                                       \
+    Size = sizeof(CLASS);                                                      \
+    break;
+#include "llvm/IR/Instruction.def"
+  default:
+    llvm_unreachable("Unknown instruction opcode");
+  }
+  // PHI nodes keep their incoming blocks next to their hung-off operands.
+  if (auto *PN = dyn_cast<PHINode>(&I))
+    Size += PN->getNumIncomingValues() * sizeof(BasicBlock *);
+  add(I.getOpcodeName(), 1, Size);
+  addUses(I);
+}
+
+void IRMemoryUsage::addConstant(const Constant &C) {
+  StringRef Kind;
+  size_t Size;
+  switch (C.getValueID()) {
+#define HANDLE_CONSTANT(Name)                                                  \
+  case Value::Name##Val:                                                       \
+    Kind = #Name;                                                              \
+    Size = sizeof(Name);                                                       \
+    break;
+#include "llvm/IR/Value.def"
+  default:
+    llvm_unreachable("Unknown constant kind");
+  }
+  // The elements of ConstantData{Array,Vector} live in a separate buffer.
+  if (auto *CDS = dyn_cast<ConstantDataSequential>(&C))
+    Size += CDS->getRawDataValues().size();
+  add(Kind, 1, Size);
+  addUses(C);
+}
+
+IRMemoryUsage::IRMemoryUsage(const Module &M) {
+  for (const GlobalValue &GV : M.global_values())
+    if (VisitedConstants.insert(&GV).second)
+      ConstantWorklist.push_back(&GV);
+
+  for (const Function &F : M) {
+    add("Argument", F.arg_size(), F.arg_size() * sizeof(Argument));
+    for (const BasicBlock &BB : F) {
+      add("BasicBlock", 1, sizeof(BasicBlock));
+      for (const Instruction &I : BB)
+        addInstruction(I);
+    }
+  }
+
+  while (!ConstantWorklist.empty())
+    addConstant(*ConstantWorklist.pop_back_val());
+}
+
+void IRMemoryUsage::print(StringRef When, raw_ostream &OS) const {
+  SmallVector<const StringMapEntry<UsageEntry> *, 64> Sorted;
+  uint64_t TotalBytes = 0;
+  for (const auto &E : Entries) {
+    Sorted.push_back(&E);
+    TotalBytes += E.second.Bytes;
+  }
+  llvm::sort(Sorted, [](const StringMapEntry<UsageEntry> *LHS,
+                        const StringMapEntry<UsageEntry> *RHS) {
+    if (LHS->second.Bytes != RHS->second.Bytes)
+      return LHS->second.Bytes > RHS->second.Bytes;
+    return LHS->first() < RHS->first();
+  });
+
+  std::string Banner = ("... IR Memory Usage (" + When + ") ...").str();
+  OS << "===" << std::string(73, '-') << "===\n"
+     << std::string((79 - Banner.size()) / 2, ' ') << Banner << '\n'
+     << "===" << std::string(73, '-') << "===\n\n";
+
+  OS << "       Count          Bytes  Kind\n";
+  for (const StringMapEntry<UsageEntry> *E : Sorted)
+    OS << format("%12llu %14llu  ", (unsigned long long)E->second.Count,
+                 (unsigned long long)E->second.Bytes)
+       << E->first() << '\n';
+  OS << format("%27llu  ", (unsigned long long)TotalBytes) << "Total\n";
+  OS << format("%27llu  ", (unsigned long long)sys::Process::GetMallocUsage())
+     << "Process malloc usage\n\n";
+  OS.flush();
+}
+
+void llvm::printIRMemoryUsage(const Module &M, StringRef When,
+                              raw_ostream &OS) {
+  IRMemoryUsage(M).print(When, OS);
+}
@@ -0,0 +1,31 @@
+//===- IRMemoryUsage.h - In-memory IR footprint report ----------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Report how much memory the in-memory IR of a module occupies, broken down
+/// by value class.
+///
+//===----------------------------------------------------------------------===//
+#ifndef LLVM_TOOLS_OPT_IRMEMORYUSAGE_H
+#define LLVM_TOOLS_OPT_IRMEMORYUSAGE_H
+
+namespace llvm {
+
+class Module;
+class raw_ostream;
+class StringRef;
+
+/// Print the number of objects and an estimate of the bytes they occupy for
+/// every instruction opcode and constant kind used by \p M, together with the
+/// Use arrays that hold their operands and the current malloc usage of the
+/// process. \p When is printed in the banner ("input", "output", ...).
+void printIRMemoryUsage(const Module &M, StringRef When, raw_ostream &OS);
+}
+
+#endif // LLVM_TOOLS_OPT_IRMEMORYUSAGE_H
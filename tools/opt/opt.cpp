@@ -14,6 +14,7 @@
 
 #include "BreakpointPrinter.h"
 #include "Debugify.h"
+#include "IRMemoryUsage.h"
 #include "NewPMDriver.h"
 #include "PassPrinters.h"
 #include "llvm/ADT/Triple.h"
@@ -226,6 +227,17 @@ static cl::opt<bool>
 PrintBreakpoints("print-breakpoints-for-testing",
                  cl::desc("Print select breakpoints location for testing"));
 
+static cl::opt<bool> PrintIRMemoryUsage(
+    "print-ir-memory-usage",
+    cl::desc("Print an estimate of the memory used by the IR of the module "
+             "before and after running the passes"));
+
+static cl::opt<bool> StreamFunctionBodies(
+    "stream-function-bodies",
+    cl::desc("Read function bodies lazily, one at a time, and delete each "
+             "one after the function passes have run on it. Requires "
+             "-disable-output or -analyze and a list of function passes"));
+
 static cl::opt<std::string> ClDataLayout("data-layout",
                                          cl::desc("data layout string to use"),
                                          cl::value_desc("layout-string"),
@@ -384,6 +396,68 @@ static void AddStandardLinkPasses(legacy::PassManagerBase &PM) {
 // CodeGen-related helper functions.
 //
 
+/// Run the passes on the command line over \p M one function at a time. Each
+/// function body is materialized right before the passes run on it and is
+/// deleted right after, so the peak memory use is bounded by the largest
+/// function instead of by the whole module. Returns false if one of the
+/// passes is not a function pass.
+static bool runStreamingFunctionPasses(const char *Argv0, Module &M,
+                                       TargetMachine *TM,
+                                       const TargetLibraryInfoImpl &TLII,
+                                       raw_ostream *AnalysisOut) {
+  legacy::FunctionPassManager FPM(&M);
+  FPM.add(new TargetLibraryInfoWrapperPass(TLII));
+  FPM.add(createTargetTransformInfoWrapperPass(
+      TM ? TM->getTargetIRAnalysis() : TargetIRAnalysis()));
+
+  for (const PassInfo *PassInf : PassList) {
+    Pass *P = nullptr;
+    if (PassInf->getNormalCtor())
+      P = PassInf->getNormalCtor()();
+    if (!P || P->getPassKind() > PT_Function) {
+      errs() << Argv0 << ": -stream-function-bodies cannot run pass '"
+             << PassInf->getPassArgument() << "'\n";
+      delete P;
+      return false;
+    }
+    PassKind Kind = P->getPassKind();
+    addPass(FPM, P);
+
+    if (AnalysisOut) {
+      switch (Kind) {
+      case PT_BasicBlock:
+        FPM.add(createBasicBlockPassPrinter(PassInf, *AnalysisOut, Quiet));
+        break;
+      case PT_Region:
+        FPM.add(createRegionPassPrinter(PassInf, *AnalysisOut, Quiet));
+        break;
+      case PT_Loop:
+        FPM.add(createLoopPassPrinter(PassInf, *AnalysisOut, Quiet));
+        break;
+      default:
+        FPM.add(createFunctionPassPrinter(PassInf, *AnalysisOut, Quiet));
+        break;
+      }
+    }
+  }
+
+  if (!NoVerify && !VerifyEach)
+    FPM.add(createVerifierPass());
+
+  FPM.doInitialization();
+  for (Function &F : M) {
+    if (F.isDeclaration())
+      continue;
+    FPM.run(F);
+    // Nothing reads the body again, so turn the function into a declaration.
+    // A declaration cannot be in a comdat.
+    F.deleteBody();
+    F.setComdat(nullptr);
+  }
+  FPM.doFinalization();
+  return true;
+}
+
 static CodeGenOpt::Level GetCodeGenOptLevel() {
   if (CodeGenOptLevel.getNumOccurrences())
     return static_cast<CodeGenOpt::Level>(unsigned(CodeGenOptLevel));
@@ -483,6 +557,22 @@ int main(int argc, char **argv) {
     return 1;
   }
 
+  if (StreamFunctionBodies) {
+    if (!NoOutput && !AnalyzeOnly) {
+      errs() << argv[0] << ": -stream-function-bodies requires "
+                           "-disable-output or -analyze.\n";
+      return 1;
+    }
+    if (PassPipeline.getNumOccurrences() > 0 || StandardLinkOpts ||
+        OptLevelO0 || OptLevelO1 || OptLevelO2 || OptLevelOs || OptLevelOz ||
+        OptLevelO3 || StripDebug || PrintEachXForm || PrintBreakpoints ||
+        RunTwice || EnableDebugify || DebugifyEach) {
+      errs() << argv[0] << ": -stream-function-bodies only supports a list "
+                           "of function passes.\n";
+      return 1;
+    }
+  }
+
   SMDiagnostic Err;
 
   Context.setDiscardValueNames(DiscardValueNames);
@@ -510,7 +600,9 @@ int main(int argc, char **argv) {
 
   // Load the input module...
   std::unique_ptr<Module> M =
-      parseIRFile(InputFilename, Err, Context, !NoVerify, ClDataLayout);
+      StreamFunctionBodies
+          ? getLazyIRFileModule(InputFilename, Err, Context)
+          : parseIRFile(InputFilename, Err, Context, !NoVerify, ClDataLayout);
 
   if (!M) {
     Err.print(argv[0], errs());
@@ -532,6 +624,9 @@ int main(int argc, char **argv) {
   // If we are supposed to override the target triple or data layout, do so now.
   if (!TargetTriple.empty())
     M->setTargetTriple(Triple::normalize(TargetTriple));
+  // parseIRFile applies the data layout while parsing; the lazy loader cannot.
+  if (StreamFunctionBodies && !ClDataLayout.empty())
+    M->setDataLayout(ClDataLayout);
 
   // Immediately run the verifier to catch any problems before starting up the
   // pass pipelines.  Otherwise we can crash on broken code during
@@ -542,6 +637,9 @@ int main(int argc, char **argv) {
     return 1;
   }
 
+  if (PrintIRMemoryUsage)
+    printIRMemoryUsage(*M, "input", errs());
+
   // Figure out what stream we are supposed to write to...
   std::unique_ptr<ToolOutputFile> Out;
   std::unique_ptr<ToolOutputFile> ThinLinkOut;
@@ -595,6 +693,23 @@ int main(int argc, char **argv) {
     if (CheckBitcodeOutputToConsole(Out->os(), !Quiet))
       NoOutput = true;
 
+  if (StreamFunctionBodies) {
+    TargetLibraryInfoImpl TLII(ModuleTriple);
+    if (DisableSimplifyLibCalls)
+      TLII.disableAllFunctions();
+    cl::PrintOptionValues();
+    if (!runStreamingFunctionPasses(argv[0], *M, TM.get(), TLII,
+                                    AnalyzeOnly ? &Out->os() : nullptr))
+      return 1;
+    if (PrintIRMemoryUsage)
+      printIRMemoryUsage(*M, "output", errs());
+    if (AnalyzeOnly)
+      Out->keep();
+    if (OptRemarkFile)
+      OptRemarkFile->keep();
+    return 0;
+  }
+
   if (PassPipeline.getNumOccurrences() > 0) {
     OutputKind OK = OK_NoOutput;
     if (!NoOutput)
@@ -611,13 +726,14 @@ int main(int argc, char **argv) {
     // The user has asked to use the new pass manager and provided a pipeline
     // string. Hand off the rest of the functionality to the new code for that
     // layer.
-    return runPassPipeline(argv[0], *M, TM.get(), Out.get(), ThinLinkOut.get(),
-                           OptRemarkFile.get(), PassPipeline, OK, VK,
-                           PreserveAssemblyUseListOrder,
-                           PreserveBitcodeUseListOrder, EmitSummaryIndex,
-                           EmitModuleHash, EnableDebugify)
-               ? 0
-               : 1;
+    bool Success = runPassPipeline(
+        argv[0], *M, TM.get(), Out.get(), ThinLinkOut.get(),
+        OptRemarkFile.get(), PassPipeline, OK, VK, PreserveAssemblyUseListOrder,
+        PreserveBitcodeUseListOrder, EmitSummaryIndex, EmitModuleHash,
+        EnableDebugify);
+    if (PrintIRMemoryUsage)
+      printIRMemoryUsage(*M, "output", errs());
+    return Success ? 0 : 1;
   }
 
   // Create a PassManager to hold and optimize the collection of passes we are
@@ -855,6 +971,9 @@ int main(int argc, char **argv) {
     Out->os() << BOS->str();
   }
 
+  if (PrintIRMemoryUsage)
+    printIRMemoryUsage(*M, "output", errs());
+
   if (DebugifyEach && !DebugifyExport.empty())
     exportDebugifyStats(DebugifyExport, Passes.getDebugifyStatsMap());
 
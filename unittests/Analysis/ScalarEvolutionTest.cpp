@@ -462,6 +462,43 @@ TEST_F(ScalarEvolutionsTest, SCEVAddExpr) {
   EXPECT_NE(nullptr, SE.getSCEV(Mul1));
 }
 
+// Asking again for an add or multiply that already exists, in any operand
+// order, returns the existing expression, with the new no-wrap flags added.
+TEST_F(ScalarEvolutionsTest, SCEVReuseExistingAddMul) {
+  Type *Ty64 = Type::getInt64Ty(Context);
+  Type *ArgTys[] = {Ty64, Ty64, Ty64};
+  FunctionType *FTy =
+      FunctionType::get(Type::getVoidTy(Context), ArgTys, false);
+  Function *F = cast<Function>(M.getOrInsertFunction("f", FTy));
+  BasicBlock *EntryBB = BasicBlock::Create(Context, "entry", F);
+  ReturnInst::Create(Context, nullptr, EntryBB);
+
+  ScalarEvolution SE = buildSE(*F);
+  auto ArgIt = F->arg_begin();
+  const SCEV *A = SE.getSCEV(&*ArgIt++);
+  const SCEV *B = SE.getSCEV(&*ArgIt++);
+  const SCEV *C = SE.getSCEV(&*ArgIt++);
+
+  SmallVector<const SCEV *, 4> Ops = {A, B, C};
+  const SCEV *Add = SE.getAddExpr(Ops);
+  EXPECT_EQ(cast<SCEVAddExpr>(Add)->getNoWrapFlags(), SCEV::FlagAnyWrap);
+  Ops = {C, A, B};
+  EXPECT_EQ(SE.getAddExpr(Ops, SCEV::FlagNSW), Add);
+  EXPECT_TRUE(cast<SCEVAddExpr>(Add)->hasNoSignedWrap());
+
+  Ops = {A, B, C};
+  const SCEV *Mul = SE.getMulExpr(Ops);
+  Ops = {B, C, A};
+  EXPECT_EQ(SE.getMulExpr(Ops, SCEV::FlagNUW), Mul);
+  EXPECT_TRUE(cast<SCEVMulExpr>(Mul)->hasNoUnsignedWrap());
+
+  // Folding still happens when the operands are not a fixed point.
+  Ops = {A, B, C, A};
+  const SCEV *Folded = SE.getAddExpr(Ops);
+  EXPECT_NE(Folded, Add);
+  EXPECT_EQ(Folded, SE.getAddExpr(Add, A));
+}
+
 static Instruction &GetInstByName(Function &F, StringRef Name) {
   for (auto &I : instructions(F))
     if (I.getName() == Name)
@@ -970,6 +1007,69 @@ TEST_F(ScalarEvolutionsTest, SCEVExitLimitForgetValue) {
   EXPECT_EQ(cast<SCEVConstant>(NewEC)->getAPInt().getLimitedValue(), 1999u);
 }
 
+// Make sure that forgetting a value drops the exit limits of every loop whose
+// backedge-taken count contains its SCEV, including loops the value does not
+// reach through its users, and keeps the others.
+TEST_F(ScalarEvolutionsTest, SCEVExitLimitForgetValueSharedExpr) {
+  LLVMContext C;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(
+      "define void @f(i64 %a, i64 %b) { "
+      "entry: "
+      "  %n = add i64 %a, %b "
+      "  %m = add i64 %a, %b "
+      "  br label %loop1 "
+      "loop1: "
+      "  %i = phi i64 [ 0, %entry ], [ %i.next, %loop1 ] "
+      "  %i.next = add nsw i64 %i, 1 "
+      "  %c1 = icmp slt i64 %i.next, %n "
+      "  br i1 %c1, label %loop1, label %loop2 "
+      "loop2: "
+      "  %j = phi i64 [ 0, %loop1 ], [ %j.next, %loop2 ] "
+      "  %j.next = add nsw i64 %j, 1 "
+      "  %c2 = icmp slt i64 %j.next, %m "
+      "  br i1 %c2, label %loop2, label %loop3 "
+      "loop3: "
+      "  %k = phi i64 [ 0, %loop2 ], [ %k.next, %loop3 ] "
+      "  %k.next = add nsw i64 %k, 1 "
+      "  %c3 = icmp slt i64 %k.next, 100 "
+      "  br i1 %c3, label %loop3, label %exit "
+      "exit: "
+      "  ret void "
+      "} ",
+      Err, C);
+
+  ASSERT_TRUE(M && "Could not parse module?");
+  ASSERT_TRUE(!verifyModule(*M) && "Must have been well formed!");
+
+  runWithSE(*M, "f", [&](Function &F, LoopInfo &LI, ScalarEvolution &SE) {
+    auto &N = GetInstByName(F, "n");
+    Argument *A = &*F.arg_begin();
+    Argument *B = &*std::next(F.arg_begin());
+    Loop *L1 = LI.getLoopFor(GetInstByName(F, "i").getParent());
+    Loop *L2 = LI.getLoopFor(GetInstByName(F, "j").getParent());
+    Loop *L3 = LI.getLoopFor(GetInstByName(F, "k").getParent());
+
+    const SCEV *EC1 = SE.getBackedgeTakenCount(L1);
+    const SCEV *EC2 = SE.getBackedgeTakenCount(L2);
+    const SCEV *EC3 = SE.getBackedgeTakenCount(L3);
+    EXPECT_TRUE(SE.hasOperand(EC1, SE.getSCEV(B)));
+    EXPECT_EQ(EC1, EC2);
+    EXPECT_TRUE(isa<SCEVConstant>(EC3));
+
+    // %n and %m share their SCEV, so both loops lose their exit limits even
+    // though only %n changes. %m is still a + b, so loop2 gets the same
+    // backedge-taken count back.
+    N.setOperand(1, A);
+    SE.forgetValue(&N);
+    const SCEV *NewEC1 = SE.getBackedgeTakenCount(L1);
+    EXPECT_FALSE(isa<SCEVCouldNotCompute>(NewEC1));
+    EXPECT_FALSE(SE.hasOperand(NewEC1, SE.getSCEV(B)));
+    EXPECT_EQ(SE.getBackedgeTakenCount(L2), EC2);
+    EXPECT_EQ(SE.getBackedgeTakenCount(L3), EC3);
+  });
+}
+
 TEST_F(ScalarEvolutionsTest, SCEVAddRecFromPHIwithLargeConstants) {
   // Reference: https://reviews.llvm.org/D37265
   // Make sure that SCEV does not blow up when constructing an AddRec
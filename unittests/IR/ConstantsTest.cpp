@@ -10,6 +10,7 @@
 #include "llvm/IR/Constants.h"
 #include "llvm-c/Core.h"
 #include "llvm/AsmParser/Parser.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/InstrTypes.h"
 #include "llvm/IR/Instruction.h"
@@ -17,6 +18,7 @@
 #include "llvm/IR/Module.h"
 #include "llvm/Support/SourceMgr.h"
 #include "gtest/gtest.h"
+#include <thread>
 
 namespace llvm {
 namespace {
@@ -476,5 +478,45 @@ TEST(ConstantsTest, BitcastToGEP) {
   ASSERT_EQ(cast<ConstantExpr>(C)->getOpcode(), Instruction::BitCast);
 }
 
+#if LLVM_ENABLE_THREADSAFE_LEAF_UNIQUING && LLVM_ENABLE_THREADS
+TEST(ConstantsTest, ConcurrentUniquing) {
+  LLVMContext Context;
+  const unsigned NumThreads = 4;
+  const unsigned NumValues = 1000;
+
+  // Every thread creates the same operand-free constants, and the types for
+  // them, in a different order. Some integer types are first created while
+  // the constant map is locked, and true and false are looked up concurrently.
+  const unsigned PerValue = 8;
+  std::vector<std::vector<Constant *>> Created(NumThreads);
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T)
+    Threads.emplace_back([&, T] {
+      std::vector<Constant *> &Values = Created[T];
+      Values.resize(PerValue * NumValues);
+      for (unsigned N = 0; N != NumValues; ++N) {
+        unsigned I = (N + T * NumValues / NumThreads) % NumValues;
+        Type *IntTy = Type::getIntNTy(Context, 2 + I % 100);
+        Constant **V = &Values[PerValue * I];
+        V[0] = ConstantInt::get(IntTy, I);
+        V[1] = ConstantFP::get(Type::getDoubleTy(Context), I);
+        V[2] = UndefValue::get(IntTy);
+        V[3] = ConstantPointerNull::get(PointerType::get(IntTy, 0));
+        V[4] = ConstantAggregateZero::get(ArrayType::get(IntTy, 1 + I % 4));
+        uint32_t Elts[] = {I + 1, I};
+        V[5] = ConstantDataArray::get(Context, Elts);
+        V[6] = ConstantInt::get(Context, APInt(200 + I % 100, I));
+        V[7] = I % 2 ? ConstantInt::getTrue(Context)
+                     : ConstantInt::getFalse(Context);
+      }
+    });
+  for (std::thread &Thread : Threads)
+    Thread.join();
+
+  for (unsigned T = 1; T != NumThreads; ++T)
+    EXPECT_EQ(Created[0], Created[T]);
+}
+#endif
+
 }  // end anonymous namespace
 }  // end namespace llvm
@@ -9,9 +9,11 @@
 
 #include "llvm/MC/StringTableBuilder.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Endian.h"
 #include "gtest/gtest.h"
 #include <string>
+#include <vector>
 
 using namespace llvm;
 
@@ -104,4 +106,78 @@ TEST(StringTableBuilderTest, ELFInOrder) {
   EXPECT_EQ(9U, B.getOffset("foobar"));
 }
 
+static std::vector<std::string> createLargeTable() {
+  // Enough strings to take the bucketed sorting path. Like C++ symbol names,
+  // most of them end in one of a few method names and parameter lists, so the
+  // buckets of their last characters are very uneven, and plenty of suffixes
+  // can be merged.
+  static const char *const Methods[] = {"3foo", "3get", "4size", "7getName"};
+  static const char *const Params[] = {"Ev",  "Ev",    "Ev",  "Ei",
+                                       "Ej",  "EPKc",  "EPv", "ERKS0_",
+                                       "ERKNS_9StringRefE"};
+  std::vector<std::string> Strings;
+  for (unsigned I = 0; I != 100000; ++I) {
+    unsigned N = I * 7919 % 100003;
+    std::string Class = "C" + std::to_string(N);
+    Strings.push_back("_ZN4llvm" + std::to_string(Class.size()) + Class +
+                      Methods[N % 4] + Params[N % 9]);
+  }
+  Strings.push_back("fooEv");
+  Strings.push_back("Ev");
+  return Strings;
+}
+
+static void setParallelSort(bool Enable) {
+  auto *Opt = static_cast<cl::opt<bool> *>(
+      cl::getRegisteredOptions()["parallel-sort-string-tables"]);
+  ASSERT_NE(nullptr, Opt);
+  Opt->setValue(Enable);
+}
+
+TEST(StringTableBuilderTest, LargeELF) {
+  std::vector<std::string> Strings = createLargeTable();
+  StringTableBuilder B(StringTableBuilder::ELF);
+  for (const std::string &S : Strings)
+    B.add(S);
+  B.finalize();
+
+  SmallString<64> Data;
+  raw_svector_ostream OS(Data);
+  B.write(OS);
+
+  // Every string is still reachable at its offset, and the suffixes were
+  // merged into longer strings.
+  for (const std::string &S : Strings) {
+    size_t Offset = B.getOffset(S);
+    ASSERT_LT(Offset + S.size(), Data.size());
+    EXPECT_EQ(S, StringRef(Data.data() + Offset, S.size()));
+    EXPECT_EQ('\0', Data[Offset + S.size()]);
+  }
+  EXPECT_NE('\0', Data[B.getOffset("fooEv") - 1]);
+  EXPECT_NE('\0', Data[B.getOffset("Ev") - 1]);
+}
+
+TEST(StringTableBuilderTest, LargeELFMatchesSerialSort) {
+  std::vector<std::string> Strings = createLargeTable();
+  StringTableBuilder Parallel(StringTableBuilder::ELF);
+  StringTableBuilder Serial(StringTableBuilder::ELF);
+  for (const std::string &S : Strings) {
+    Parallel.add(S);
+    Serial.add(S);
+  }
+  Parallel.finalize();
+  setParallelSort(false);
+  Serial.finalize();
+  setParallelSort(true);
+
+  SmallString<64> ParallelData, SerialData;
+  raw_svector_ostream ParallelOS(ParallelData), SerialOS(SerialData);
+  Parallel.write(ParallelOS);
+  Serial.write(SerialOS);
+
+  EXPECT_TRUE(SerialData.str() == ParallelData.str());
+  for (const std::string &S : Strings)
+    EXPECT_EQ(Serial.getOffset(S), Parallel.getOffset(S));
+}
+
 }
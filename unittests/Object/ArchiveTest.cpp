@@ -0,0 +1,149 @@
+//===- ArchiveTest.cpp - Tests for Archive.cpp and ArchiveWriter.cpp ------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Object/Archive.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Object/ArchiveWriter.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace llvm;
+using namespace object;
+
+namespace {
+
+// Bitcode for a module that defines the given functions.
+static std::string createMember(ArrayRef<StringRef> Functions) {
+  std::string IR;
+  for (StringRef F : Functions)
+    IR += ("define void @" + F + "() { ret void }\n").str();
+  LLVMContext Context;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(IR, Err, Context);
+  EXPECT_TRUE(M);
+  std::string Bitcode;
+  raw_string_ostream OS(Bitcode);
+  WriteBitcodeToFile(*M, OS);
+  return OS.str();
+}
+
+class ArchiveSymbolsTest : public testing::Test {
+protected:
+  std::vector<std::string> Members;
+  std::unique_ptr<MemoryBuffer> ArchiveBuf;
+  std::unique_ptr<Archive> A;
+
+  void SetUp() override {
+    // Enough members that the writer reads their symbols concurrently. Every
+    // member defines "dup", so lookups must find the first one.
+    for (unsigned I = 0; I != 8; ++I) {
+      std::string F = "f" + std::to_string(I), G = "g" + std::to_string(I);
+      Members.push_back(createMember({F, "dup", G}));
+    }
+    std::vector<NewArchiveMember> NewMembers;
+    for (unsigned I = 0; I != Members.size(); ++I)
+      NewMembers.emplace_back(MemoryBufferRef(Members[I], MemberNames[I]));
+
+    SmallString<128> Path;
+    ASSERT_FALSE(sys::fs::createTemporaryFile("ArchiveTest", "a", Path));
+    FileRemover Remover(Path);
+    ASSERT_FALSE(errorToBool(writeArchive(Path, NewMembers,
+                                          /*WriteSymtab=*/true, Archive::K_GNU,
+                                          /*Deterministic=*/true,
+                                          /*Thin=*/false)));
+    auto BufOrErr = MemoryBuffer::getFile(Path);
+    ASSERT_TRUE(bool(BufOrErr));
+    ArchiveBuf = std::move(*BufOrErr);
+
+    Expected<std::unique_ptr<Archive>> AOrErr =
+        Archive::create(ArchiveBuf->getMemBufferRef());
+    ASSERT_FALSE(errorToBool(AOrErr.takeError()));
+    A = std::move(*AOrErr);
+  }
+
+  static const char *const MemberNames[8];
+};
+
+const char *const ArchiveSymbolsTest::MemberNames[8] = {
+    "m0.bc", "m1.bc", "m2.bc", "m3.bc", "m4.bc", "m5.bc", "m6.bc", "m7.bc"};
+
+static std::string memberName(Expected<Optional<Archive::Child>> C) {
+  if (!C) {
+    consumeError(C.takeError());
+    return "<error>";
+  }
+  if (!*C)
+    return "<none>";
+  Expected<StringRef> Name = (*C)->getName();
+  if (!Name) {
+    consumeError(Name.takeError());
+    return "<error>";
+  }
+  return *Name;
+}
+
+TEST_F(ArchiveSymbolsTest, SymbolTable) {
+  // The symbol table lists every member's symbols in member order, each
+  // pointing at its own member.
+  std::vector<std::string> Names, Owners;
+  for (const Archive::Symbol &Sym : A->symbols()) {
+    Names.push_back(Sym.getName());
+    Expected<Archive::Child> C = Sym.getMember();
+    ASSERT_FALSE(errorToBool(C.takeError()));
+    Expected<StringRef> Owner = C->getName();
+    ASSERT_FALSE(errorToBool(Owner.takeError()));
+    Owners.push_back(*Owner);
+  }
+  ASSERT_EQ(3 * Members.size(), Names.size());
+  for (unsigned I = 0; I != Members.size(); ++I) {
+    EXPECT_EQ("f" + std::to_string(I), Names[3 * I]);
+    EXPECT_EQ("dup", Names[3 * I + 1]);
+    EXPECT_EQ("g" + std::to_string(I), Names[3 * I + 2]);
+    for (unsigned J = 0; J != 3; ++J)
+      EXPECT_EQ(MemberNames[I], Owners[3 * I + J]);
+  }
+}
+
+TEST_F(ArchiveSymbolsTest, FindSym) {
+  for (unsigned I = 0; I != Members.size(); ++I) {
+    EXPECT_EQ(MemberNames[I], memberName(A->findSym("f" + std::to_string(I))));
+    EXPECT_EQ(MemberNames[I], memberName(A->findSym("g" + std::to_string(I))));
+  }
+  EXPECT_EQ(MemberNames[0], memberName(A->findSym("dup")));
+  EXPECT_EQ("<none>", memberName(A->findSym("missing")));
+}
+
+#if LLVM_ENABLE_THREADS
+TEST_F(ArchiveSymbolsTest, FindSymConcurrently) {
+  // The first lookups race to build the index.
+  std::vector<std::string> Found(Members.size());
+  std::vector<std::thread> Threads;
+  for (unsigned I = 0; I != Members.size(); ++I)
+    Threads.emplace_back([&, I] {
+      Found[I] = memberName(A->findSym("g" + std::to_string(I)));
+    });
+  for (std::thread &T : Threads)
+    T.join();
+  for (unsigned I = 0; I != Members.size(); ++I)
+    EXPECT_EQ(MemberNames[I], Found[I]);
+}
+#endif
+
+} // end anonymous namespace
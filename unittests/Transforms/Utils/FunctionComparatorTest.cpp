@@ -128,3 +128,22 @@ TEST(FunctionComparatorTest, TestAPI) {
   EXPECT_EQ(Cmp.testCmpTypes(F1.T, F2.T), 0);
   EXPECT_EQ(Cmp.testCmpPrimitives(), -4);
 }
+
+/// Functions that only differ in a constant share a functionHash, but their
+/// fingerprints tell them apart.
+TEST(FunctionComparatorTest, Fingerprint) {
+  LLVMContext C;
+  Module M("test", C);
+  TestFunction F1(C, M, 27);
+  TestFunction F2(C, M, 27);
+  TestFunction F3(C, M, 28);
+
+  EXPECT_EQ(FunctionComparator::functionHash(*F1.F),
+            FunctionComparator::functionHash(*F3.F));
+  EXPECT_EQ(FunctionComparator::functionFingerprint(*F1.F),
+            FunctionComparator::functionFingerprint(*F2.F));
+  EXPECT_NE(FunctionComparator::functionFingerprint(*F1.F),
+            FunctionComparator::functionFingerprint(*F3.F));
+  EXPECT_EQ(FunctionComparator(F1.F, F2.F, nullptr).compare(), 0);
+  EXPECT_NE(FunctionComparator(F1.F, F3.F, nullptr).compare(), 0);
+}